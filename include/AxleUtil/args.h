@@ -2,10 +2,18 @@
 #define AXLEUTIL_ARGS_H_
 
 #include <AxleUtil/safe_lib.h>
+#include <AxleUtil/utility.h>
+#include <AxleUtil/hash.h>
+#include <AxleUtil/parse.h>
 
 namespace clArg {
+  using Axle::u8;
+  using Axle::u32;
+  using Axle::u64;
   using Axle::usize;
   using Axle::ViewArr;
+  using Axle::memeq_ts;
+  using Axle::strlen_ts;
 
   struct ArgsList {
     usize argc = 0;
@@ -49,20 +57,49 @@ namespace clArg {
     }
   };
 
+  template<typename T>
+    requires(std::is_integral_v<T> && !Axle::OneOf<T, bool, char>)
+  struct Parser<T> {
+    template<typename E>
+    constexpr static bool try_parse(E& err, const ViewArr<const char>& val,
+                                    const ViewArr<const char>& name, T& out) {
+      if (!Axle::parse_number(val, out)) {
+        err.report_error("{}: Expected integer in range [{}, {}]. Found: \"{}\"", name,
+                         std::numeric_limits<T>::min(), std::numeric_limits<T>::max(), val);
+        return false;
+      }
+
+      return true;
+    }
+  };
+
+  template<typename T>
+    requires(Axle::OneOf<T, float, double>)
+  struct Parser<T> {
+    template<typename E>
+    static bool try_parse(E& err, const ViewArr<const char>& val,
+                          const ViewArr<const char>& name, T& out) {
+      if (!Axle::parse_number(val, out)) {
+        err.report_error("{}: Expected number. Found: \"{}\"", name, val);
+        return false;
+      }
+
+      return true;
+    }
+  };
+
   constexpr ViewArr<const char> arg_val(const char* str, const ViewArr<const char>& name) {
     if (str[0] != '-') return {};
     str += 1;
 
+    // Stops at the first difference (including the null terminator), so other arguments only cost O(name)
     for (usize i = 0; i < name.size; ++i) {
       if (str[i] != name[i]) return {};
     }
-
     if (str[name.size] != '=') return {};
-    str += name.size + 1;
-    const char* start = str;
-    while (str[0] != '\0') str += 1;
 
-    return { start, static_cast<usize>(str - start) };
+    const char* val = str + name.size + 1;
+    return { val, strlen_ts(val) };
   }
 
   template<typename E, typename T>
@@ -78,8 +115,184 @@ namespace clArg {
     return false;
   }
 
+  // Keys are views into the arguments and response files so are never copied
+  struct ArgsIndexTrait {
+    using value_t = ViewArr<const char>;
+    using param_t = ViewArr<const char>;
+
+    static constexpr char TOMBSTONE_CHAR = '\0';
+    static constexpr const value_t EMPTY = { nullptr, 0 };
+    static constexpr const value_t TOMBSTONE = { &TOMBSTONE_CHAR, 0 };
+
+    static constexpr u64 hash(param_t s) noexcept {
+      return Axle::fnv1a_hash(s.data, s.size);
+    }
+
+    // Option names are never empty, so empty views are only equal to themselves
+    static constexpr bool eq(param_t s0, param_t s1) noexcept {
+      if (s0.size != s1.size) return false;
+      if (s0.size == 0) return s0.data == s1.data;
+      return memeq_ts<char>(s0.data, s1.data, s0.size);
+    }
+  };
+
+  // Every "-name=value" argument grouped by name, built in one pass by build_index
+  // Repeated options keep all their values in the order they were given
+  struct ArgsIndex {
+    struct Values {
+      u32 first;
+      u32 count;
+    };
+
+    Axle::Array<ViewArr<const char>> values = {};
+    Axle::Hash::InternalHashTable<ViewArr<const char>, Values, ArgsIndexTrait> options = {};
+    Axle::Array<Axle::OwnedArr<u8>> response_files = {};
+
+    ViewArr<const ViewArr<const char>> get(const ViewArr<const char>& name) const {
+      const Values* v = options.get_val(name);
+      if (v == nullptr) return {};
+      return { values.data + v->first, v->count };
+    }
+  };
+
+  constexpr usize MAX_RESPONSE_FILE_DEPTH = 16;
+
+  // Returns false if the file could not be read
+  bool read_response_file(const ViewArr<const char>& path, Axle::OwnedArr<u8>& out);
+
+  namespace IndexInternal {
+    struct Pending {
+      ViewArr<const char> name;
+      ViewArr<const char> value;
+    };
+
+    // The name ends at the first '=', unlike arg_val which can match names containing one
+    constexpr bool split_arg(const ViewArr<const char>& arg, Pending& out) {
+      if (arg.size < 2 || arg[0] != '-') return false;
+
+      for (usize i = 2; i < arg.size; ++i) {
+        if (arg[i] == '=') {
+          out.name = Axle::view_arr(arg, 1, i - 1);
+          out.value = Axle::view_arr(arg, i + 1, arg.size - (i + 1));
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    constexpr bool is_space(char c) {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Tokens are separated by whitespace, which is kept inside '"' quotes anywhere in a token
+    // Quotes are removed by moving the rest of the token back over them, so the token is a view into rest
+    constexpr bool next_token(ViewArr<char>& rest, ViewArr<const char>& token) {
+      usize i = 0;
+      while (i < rest.size && is_space(rest[i])) ++i;
+      if (i == rest.size) return false;
+
+      const usize start = i;
+      usize end = i;
+      bool quoted = false;
+      for (; i < rest.size; ++i) {
+        const char c = rest[i];
+        if (c == '"') {
+          quoted = !quoted;
+        }
+        else if (!quoted && is_space(c)) {
+          break;
+        }
+        else {
+          rest[end] = c;
+          end += 1;
+        }
+      }
+
+      token = { rest.data + start, end - start };
+      rest = Axle::view_arr(rest, i, rest.size - i);
+      return true;
+    }
+
+    template<typename E>
+    bool add_arg(E& err, ArgsIndex& index, Axle::Array<Pending>& pending,
+                 const ViewArr<const char>& arg, usize depth) {
+      if (arg.size > 0 && arg[0] == '@') {
+        const ViewArr<const char> path = Axle::view_arr(arg, 1, arg.size - 1);
+        if (depth >= MAX_RESPONSE_FILE_DEPTH) {
+          err.report_error("Response files nested too deeply at: \"{}\"", path);
+          return false;
+        }
+
+        Axle::OwnedArr<u8> file = {};
+        if (!read_response_file(path, file)) {
+          err.report_error("Could not read response file: \"{}\"", path);
+          return false;
+        }
+
+        // The data does not move when the array grows, so views into it stay valid
+        ViewArr<char> rest = { reinterpret_cast<char*>(file.data), file.size };
+        index.response_files.insert(std::move(file));
+
+        ViewArr<const char> token;
+        while (next_token(rest, token)) {
+          if (!add_arg(err, index, pending, token, depth + 1)) return false;
+        }
+        return true;
+      }
+
+      Pending p;
+      if (split_arg(arg, p)) {
+        index.options.get_or_create(p.name)->count += 1;
+        pending.insert(p);
+      }
+      return true;
+    }
+  }
+
+  // Expands "@path" arguments to the contents of that file, then indexes the options
+  // Use this over parse_arg on ArgsList when there are many arguments, as that rescans them per option
+  template<typename E>
+  bool build_index(E& err, const ArgsList& args, ArgsIndex& index) {
+    ASSERT(index.values.size == 0 && index.options.used == 0);
+
+    Axle::Array<IndexInternal::Pending> pending = {};
+    pending.reserve_total(args.argc);
+    for (const char* a : args) {
+      if (!IndexInternal::add_arg(err, index, pending, { a, strlen_ts(a) }, 0)) return false;
+    }
+
+    // Give each option a contiguous run of values
+    u32 offset = 0;
+    for (auto it = index.options.itr(); it.is_valid(); it.next()) {
+      ArgsIndex::Values* v = it.val();
+      v->first = offset;
+      offset += v->count;
+      v->count = 0;
+    }
+
+    index.values.insert_uninit(pending.size);
+    for (const IndexInternal::Pending& p : pending) {
+      ArgsIndex::Values* v = index.options.get_val(p.name);
+      index.values[v->first + v->count] = p.value;
+      v->count += 1;
+    }
+
+    return true;
+  }
+
   template<typename E, typename T>
-  bool parse_arg(E& err, const ArgsList& args, const ViewArr<const char>& name, T& t) {
+  bool parse_opt_arg(E& err, const ArgsIndex& index, const ViewArr<const char>& name, T& t) {
+    for (const ViewArr<const char>& v : index.get(name)) {
+      bool r = Parser<T>::try_parse(err, v, name, t);
+      if (r) return true;
+    }
+
+    return false;
+  }
+
+  template<typename E, typename Args, typename T>
+  bool parse_arg(E& err, const Args& args, const ViewArr<const char>& name, T& t) {
     bool found = parse_opt_arg(err, args, name, t);
     if (!found) {
       err.report_error("Did not find argument: {}", name);
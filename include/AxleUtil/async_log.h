@@ -0,0 +1,37 @@
+#ifndef AXLEUTIL_ASYNC_LOG_H_
+#define AXLEUTIL_ASYNC_LOG_H_
+
+#include <AxleUtil/io.h>
+
+namespace Axle::LOG {
+  // What a thread does when its ring has no room for a record
+  enum struct AsyncPolicy : u8 {
+    Drop,// count it in dropped_count() and carry on
+    Block,// wait for the drain thread to make room
+  };
+
+  // Called on the drain thread with a batch of whole records (and once more by stop_async)
+  using AsyncSink = void(*)(const ViewArr<const char>& batch, void* data);
+
+  struct AsyncConfig {
+    usize ring_size = 64 * 1024;// per thread, must be a power of 2
+    AsyncPolicy policy = AsyncPolicy::Drop;
+    u32 idle_sleep_ms = 1;
+
+    AsyncSink sink = nullptr;// nullptr writes to stderr under the io lock
+    void* sink_data = nullptr;
+  };
+
+  // While running LOG::debug/warn/error format into a ring owned by the calling thread
+  // and a background thread writes them out in batches
+  // Records too big for a ring are still written synchronously
+  void start_async(const AsyncConfig& config = {});
+
+  // Writes out everything already logged then joins the drain thread
+  // Threads should have stopped logging before this is called
+  void stop_async();
+
+  u64 dropped_count();
+}
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef AXLEUTIL_BINARY_LOG_H_
+#define AXLEUTIL_BINARY_LOG_H_
+
+#include <AxleUtil/format.h>
+#include <AxleUtil/serialize.h>
+#include <AxleUtil/threading.h>
+#include <AxleUtil/hash.h>
+#include <AxleUtil/log_level.h>
+
+#include <bit>
+
+namespace Axle::LOG {
+  // Binary logs start with BINARY_LOG_MAGIC then a version byte
+  // After that every entry starts with a BinaryEntry byte, all numbers are little endian
+  //   Format: u32 id, u8 arg count, a BinaryArg per arg, u32 length, the format string
+  //   Record: u8 level, u32 id, the args
+  //   Text:   u8 level, u32 length, an already formatted message
+  inline constexpr u8 BINARY_LOG_MAGIC[4] = { 'A', 'X', 'L', 'B' };
+  inline constexpr u8 BINARY_LOG_VERSION = 1;
+
+  enum struct BinaryEntry : u8 {
+    Format = 0,
+    Record = 1,
+    Text = 2,
+  };
+
+  // How an argument is stored, strings are a u32 length then the bytes
+  enum struct BinaryArg : u8 {
+    Bool, Char,
+    U8, U16, U32, U64,
+    I8, I16, I32, I64,
+    F32, F64,
+    String,
+  };
+
+  // Types that can be logged without formatting them first
+  // Anything else makes the whole record fall back to a formatted Text entry
+  template<typename T>
+  struct BinaryLogArg;
+
+  template<typename T>
+  concept BinaryLoggable = requires {
+    BinaryLogArg<T>::TYPE;
+  };
+
+  template<>
+  struct BinaryLogArg<bool> {
+    static constexpr BinaryArg TYPE = BinaryArg::Bool;
+    static constexpr usize serialized_size(bool) { return 1; }
+
+    template<typename S>
+    static constexpr void serialize(S& ser, bool b) {
+      serialize_le(ser, static_cast<u8>(b));
+    }
+  };
+
+  template<>
+  struct BinaryLogArg<char> {
+    static constexpr BinaryArg TYPE = BinaryArg::Char;
+    static constexpr usize serialized_size(char) { return 1; }
+
+    template<typename S>
+    static constexpr void serialize(S& ser, char c) {
+      serialize_le(ser, static_cast<u8>(c));
+    }
+  };
+
+  template<typename T>
+    requires(std::is_integral_v<T> && !OneOf<T, bool, char>)
+  struct BinaryLogArg<T> {
+    static constexpr BinaryArg TYPE = [] {
+      constexpr usize S = sizeof(T);
+      if constexpr (std::is_signed_v<T>) {
+        return S == 1 ? BinaryArg::I8 : S == 2 ? BinaryArg::I16 : S == 4 ? BinaryArg::I32 : BinaryArg::I64;
+      }
+      else {
+        return S == 1 ? BinaryArg::U8 : S == 2 ? BinaryArg::U16 : S == 4 ? BinaryArg::U32 : BinaryArg::U64;
+      }
+    }();
+
+    static constexpr usize serialized_size(T) { return sizeof(T); }
+
+    template<typename S>
+    static constexpr void serialize(S& ser, T t) {
+      using U = std::conditional_t<sizeof(T) == 1, u8,
+                std::conditional_t<sizeof(T) == 2, u16,
+                std::conditional_t<sizeof(T) == 4, u32, u64>>>;
+      serialize_le(ser, static_cast<U>(t));
+    }
+  };
+
+  template<>
+  struct BinaryLogArg<float> {
+    static constexpr BinaryArg TYPE = BinaryArg::F32;
+    static constexpr usize serialized_size(float) { return 4; }
+
+    template<typename S>
+    static constexpr void serialize(S& ser, float f) {
+      serialize_le(ser, std::bit_cast<u32>(f));
+    }
+  };
+
+  template<>
+  struct BinaryLogArg<double> {
+    static constexpr BinaryArg TYPE = BinaryArg::F64;
+    static constexpr usize serialized_size(double) { return 8; }
+
+    template<typename S>
+    static constexpr void serialize(S& ser, double d) {
+      serialize_le(ser, std::bit_cast<u64>(d));
+    }
+  };
+
+  template<typename S>
+  void serialize_log_string(S& ser, const char* str, usize len) {
+    serialize_le(ser, static_cast<u32>(len));
+    ser.write_bytes({ reinterpret_cast<const u8*>(str), len });
+  }
+
+  template<>
+  struct BinaryLogArg<ViewArr<const char>> {
+    static constexpr BinaryArg TYPE = BinaryArg::String;
+    static constexpr usize serialized_size(const ViewArr<const char>& s) { return 4 + s.size; }
+
+    template<typename S>
+    static void serialize(S& ser, const ViewArr<const char>& s) {
+      serialize_log_string(ser, s.data, s.size);
+    }
+  };
+
+  template<>
+  struct BinaryLogArg<ViewArr<char>> {
+    static constexpr BinaryArg TYPE = BinaryArg::String;
+    static constexpr usize serialized_size(const ViewArr<char>& s) { return 4 + s.size; }
+
+    template<typename S>
+    static void serialize(S& ser, const ViewArr<char>& s) {
+      serialize_log_string(ser, s.data, s.size);
+    }
+  };
+
+  // Matches FormatArg<char[N]>, which drops the null terminator
+  template<usize N>
+  struct BinaryLogArg<char[N]> {
+    static constexpr BinaryArg TYPE = BinaryArg::String;
+    static constexpr usize serialized_size(const char(&)[N]) { return 4 + N - 1; }
+
+    template<typename S>
+    static void serialize(S& ser, const char(&arr)[N]) {
+      serialize_log_string(ser, arr, N - 1);
+    }
+  };
+
+  // The same literal can be pooled between call sites logging different types, so both make up the key
+  struct BinaryFormatKey {
+    const char* format;
+    const BinaryArg* types;
+  };
+
+  struct BinaryFormatTrait {
+    using value_t = BinaryFormatKey;
+    using param_t = BinaryFormatKey;
+
+    static constexpr char TOMBSTONE_CHAR = '\0';
+    static constexpr const value_t EMPTY = { nullptr, nullptr };
+    static constexpr const value_t TOMBSTONE = { &TOMBSTONE_CHAR, nullptr };
+
+    static u64 hash(param_t k) noexcept {
+      const u64 h = fnv1a_hash_u64(FNV1_HASH_BASE, static_cast<u64>(reinterpret_cast<uintptr_t>(k.format)));
+      return fnv1a_hash_u64(h, static_cast<u64>(reinterpret_cast<uintptr_t>(k.types)));
+    }
+    static constexpr bool eq(param_t k0, param_t k1) noexcept {
+      return k0.format == k1.format && k0.types == k1.types;
+    }
+  };
+
+  // Records the identity of each format string plus its serialized arguments
+  // Format strings are identified by their address and argument types, so each one is only written out once
+  // Bytes are handed to the sink whenever flush_size is reached and when flushed or destroyed
+  struct BinaryLog {
+    using Sink = void(*)(const ViewArr<const u8>& bytes, void* data);
+    static constexpr usize DEFAULT_FLUSH_SIZE = 64 * 1024;
+
+    Mutex mutex = {};
+    Array<u8> bytes = {};
+    usize flush_size = DEFAULT_FLUSH_SIZE;
+
+    Sink sink = nullptr;
+    void* sink_data = nullptr;
+
+    Hash::InternalHashTable<BinaryFormatKey, u32, BinaryFormatTrait> format_ids = {};
+    u32 next_id = 0;
+
+    BinaryLog(Sink sink, void* sink_data, usize flush_size = DEFAULT_FLUSH_SIZE);
+    ~BinaryLog();
+
+    BinaryLog(const BinaryLog&) = delete;
+    BinaryLog(BinaryLog&&) = delete;
+    BinaryLog& operator=(const BinaryLog&) = delete;
+    BinaryLog& operator=(BinaryLog&&) = delete;
+
+    void flush();
+
+    // Must be called with the mutex held
+    u32 format_id(const ViewArr<const char>& format, const ViewArr<const BinaryArg>& types);
+    ViewArr<u8> begin_entry(usize size);
+    void end_entry(usize size);
+
+    template<typename ... T>
+    void write(Level level, const Format::FormatString<T...>& format, const T& ... ts) {
+      mutex.acquire();
+
+      if constexpr ((BinaryLoggable<T> && ...)) {
+        // Extra entry so the array is never empty
+        static constexpr BinaryArg TYPES[sizeof...(T) + 1] = { BinaryLogArg<T>::TYPE..., BinaryArg::Bool };
+        const u32 id = format_id(format.str, { TYPES, sizeof...(T) });
+
+        const usize size = 1 + 1 + 4 + (BinaryLogArg<T>::serialized_size(ts) + ... + 0);
+        Serializer<ViewArr<u8>, ByteOrder::LittleEndian> ser = begin_entry(size);
+        serialize_le(ser, static_cast<u8>(BinaryEntry::Record));
+        serialize_le(ser, static_cast<u8>(level));
+        serialize_le(ser, id);
+        (BinaryLogArg<T>::serialize(ser, ts), ...);
+        ASSERT(ser.view.size == 0);
+        end_entry(size);
+      }
+      else {
+        const usize len = Format::formatted_size(format, ts...);
+
+        const usize size = 1 + 1 + 4 + len;
+        const ViewArr<u8> entry = begin_entry(size);
+        Serializer<ViewArr<u8>, ByteOrder::LittleEndian> ser = entry;
+        serialize_le(ser, static_cast<u8>(BinaryEntry::Text));
+        serialize_le(ser, static_cast<u8>(level));
+        serialize_le(ser, static_cast<u32>(len));
+
+        Format::ViewFormatter result = ViewArr<char>{ reinterpret_cast<char*>(ser.view.data), len };
+        Format::format_to(result, format, ts...);
+        ASSERT(result.view.size == len);
+        end_entry(size);
+      }
+
+      mutex.release();
+    }
+  };
+
+  // While set LOG::debug/warn/error write to this log instead of formatting
+  void set_binary_log(BinaryLog* log);
+  BinaryLog* binary_log();
+
+  // Appends the text LOG::* would have written for each entry
+  // Returns false if the data is not a complete binary log
+  bool decode_binary_log(const ViewArr<const u8>& data, Array<char>& out);
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define AXLEUTIL_FILES_H_
 
 #include <AxleUtil/utility.h>
-#include <AxleUtil/formattable.h>
+#include <AxleUtil/format.h>
 
 #include <AxleUtil/os/os_windows_files.h>
 
@@ -14,11 +14,14 @@ namespace FILES {
   using OpenedFile = Base::OpenedFile<FileData>;
 
   OpenedFile open(const ViewArr<const char>& name,
-                  OPEN_MODE open_mode);
+                  OPEN_MODE open_mode,
+                  const BufferOptions& buffer_options = {});
   OpenedFile create(const ViewArr<const char>& name,
-                    OPEN_MODE open_mode);
+                    OPEN_MODE open_mode,
+                    const BufferOptions& buffer_options = {});
   OpenedFile replace(const ViewArr<const char>& name,
-                     OPEN_MODE open_mode);
+                     OPEN_MODE open_mode,
+                     const BufferOptions& buffer_options = {});
 
   void close(FileHandle);
 
@@ -41,6 +44,9 @@ namespace FILES {
 
   OwnedArr<u8> read_full_file(const ViewArr<const char>& file_name);
 
+  // Maps the whole file, an empty file maps to an empty view
+  ErrorCode map_file(MappedFile& mapped, const ViewArr<const char>& file_name, MAP_MODE map_mode);
+
   ErrorCode write(FileHandle file, const uint8_t* arr, size_t length);
   ErrorCode write_padding_bytes(FileHandle file, uint8_t byte, size_t num);
 
@@ -98,14 +104,84 @@ namespace FILES {
     }
   };
 
+  // Collects output and writes it to the file in large blocks
+  // Flushed on destruction, but call flush first to see any errors
+  struct BufferedFileFormatter {
+    constexpr static usize DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+    FileHandle handle = {};
+    ErrorCode errors = ErrorCode::OK;
+    OwnedArr<u8> buffer = {};
+    usize used = 0;
+
+    BufferedFileFormatter(FileHandle handle, usize buffer_size = DEFAULT_BUFFER_SIZE);
+    ~BufferedFileFormatter();
+
+    BufferedFileFormatter(const BufferedFileFormatter&) = delete;
+    BufferedFileFormatter(BufferedFileFormatter&&) = delete;
+    BufferedFileFormatter& operator=(const BufferedFileFormatter&) = delete;
+    BufferedFileFormatter& operator=(BufferedFileFormatter&&) = delete;
+
+    constexpr bool is_ok() { return errors == ErrorCode::OK; }
+
+    ErrorCode flush();
+
+    void load_string(const char* str, usize N);
+
+    template<usize N>
+    void load_string_lit(const char(&str)[N]) {
+      ASSERT(str[N - 1] == '\0');
+      load_string(str, N - 1);
+    }
+
+    template<usize N>
+    void load_string_exact(const char(&str)[N]) {
+      load_string(str, N);
+    }
+
+    inline void load_char(char c) {
+      ASSERT(c != '\0');
+      if (used == buffer.size) {
+        flush();
+      }
+      if(!is_ok()) return;
+
+      buffer[used] = static_cast<u8>(c);
+      used += 1;
+    }
+  };
+
+  // Formats the whole string first so the file only sees one write
   template<typename ... T>
   ErrorCode format_write(FileHandle handle, const Format::FormatString<T...>& format, const T& ... ts) {
-    FileFormatter result;
-    result.handle = handle;
-
+    Format::ArrayFormatter result = {};
     Format::format_to(result, format, ts...);
 
-    return result.errors;
+    const ViewArr<const char> view = result.view();
+    if (view.size == 0) return ErrorCode::OK;
+
+    return write(handle, reinterpret_cast<const u8*>(view.data), view.size);
+  }
+
+  // Writes format once per element of the arrays, which must all be the same size
+  // e.g. format_write_many(handle, "{}: {}\n", const_view_arr(names), const_view_arr(values))
+  template<typename ... T>
+  ErrorCode format_write_many(FileHandle handle, const Format::FormatString<T...>& format,
+                              const ViewArr<const T>& ... arrays) {
+    static_assert(sizeof...(T) > 0, "Nothing to write many of");
+
+    const usize sizes[] = { arrays.size... };
+    const usize count = sizes[0];
+    for (usize s : sizes) {
+      ASSERT(s == count);
+    }
+
+    BufferedFileFormatter result = { handle };
+    for (usize i = 0; i < count && result.is_ok(); ++i) {
+      Format::format_to(result, format, arrays[i]...);
+    }
+
+    return result.flush();
   }
 
 }
@@ -2,8 +2,11 @@
 #define AXLEUTIL_FILES_BASE_H_
 
 #include <AxleUtil/safe_lib.h>
+#include <AxleUtil/memory.h>
 #include <AxleUtil/formattable.h>
 
+#include <utility>
+
 namespace Axle::FILES {
 #define FILE_ERROR_CODES_X \
 modify(OK)\
@@ -11,6 +14,8 @@ modify(COULD_NOT_CREATE_FILE)\
 modify(COULD_NOT_OPEN_FILE)\
 modify(COULD_NOT_CLOSE_FILE)\
 modify(COULD_NOT_DELETE_FILE)\
+modify(COULD_NOT_MAP_FILE)\
+modify(INVALID_FILE_FORMAT)\
 
   enum struct ErrorCode : u8 {
   #define modify(NAME) NAME,
@@ -41,6 +46,55 @@ return lit_view_arr(ErrorCodeString :: NAME);
     READ = 'r', WRITE = 'w'
   };
 
+  enum struct MAP_MODE : u8 {
+    READ_ONLY = 'r',
+    // Writes are private to this process and never reach the file
+    COPY_ON_WRITE = 'c',
+  };
+
+  // A whole file mapped into memory
+  struct MappedFile {
+    u8* data = nullptr;
+    usize size = 0;
+    void* native_mapping = nullptr;
+
+    MappedFile() noexcept = default;
+
+    MappedFile(MappedFile&& m) noexcept
+      : data(std::exchange(m.data, nullptr)),
+        size(std::exchange(m.size, 0)),
+        native_mapping(std::exchange(m.native_mapping, nullptr)) {}
+
+    MappedFile& operator=(MappedFile&& m) noexcept {
+      if (this == &m) return *this;
+
+      close();
+      data = std::exchange(m.data, nullptr);
+      size = std::exchange(m.size, 0);
+      native_mapping = std::exchange(m.native_mapping, nullptr);
+
+      return *this;
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() noexcept {
+      close();
+    }
+
+    // Implemented per os
+    void close() noexcept;
+
+    constexpr bool is_mapped() const noexcept {
+      return native_mapping != nullptr;
+    }
+
+    constexpr ViewArr<const u8> view() const noexcept {
+      return { data, size };
+    }
+  };
+
   enum struct DirectoryElementType {
     File, Directory,
   };
@@ -52,6 +106,19 @@ return lit_view_arr(ErrorCodeString :: NAME);
 
   struct DirectoryIteratorEnd {};
 
+  // How an opened file buffers its reads and writes
+  struct BufferOptions {
+    static constexpr usize MIN_SIZE = 4 * 1024;
+    static constexpr usize MAX_SIZE = 4 * 1024 * 1024;
+    static constexpr usize DEFAULT_SIZE = MIN_SIZE;
+
+    // Clamped to [MIN_SIZE, MAX_SIZE]
+    usize size = DEFAULT_SIZE;
+    // Doubles the buffer, and so the read-ahead, each time an access carries on from the end of the last one
+    // Any other access returns it to size
+    bool adaptive = false;
+  };
+
   namespace Base {
   // Need to implemented per file handle
   template<typename T>
@@ -68,8 +135,6 @@ return lit_view_arr(ErrorCodeString :: NAME);
 
   template<typename F>
   struct FileData {
-    static constexpr usize BUFFER_SIZE = 1024;
-  
     F file_handle;
 
     usize real_file_ptr = 0;
@@ -81,11 +146,18 @@ return lit_view_arr(ErrorCodeString :: NAME);
     usize real_buffer_ptr = 0;
 
     bool in_sync = true;
+    bool adaptive = false;
     u32 buffer_size = 0;
-    u8 buffer[BUFFER_SIZE] = {};
+    u32 buffer_capacity = 0;
+    // What an adaptive buffer returns to after a non-sequential access
+    u32 base_capacity = 0;
+    u8* buffer = nullptr;
 
-    FileData(F f) noexcept;
+    FileData(F f, const BufferOptions& options = {}) noexcept;
     ~FileData() noexcept;
+
+    FileData(const FileData&) = delete;
+    FileData& operator=(const FileData&) = delete;
   };
 
   template<typename T>
@@ -114,62 +186,42 @@ return lit_view_arr(ErrorCodeString :: NAME);
     }
   }
 
-  struct BufferRange {
-    usize ptr_start = 0;
-    u32 buffer_start = 0;
-    u32 size = 0;
-  };
-
   template<typename T>
-  static BufferRange get_loaded_range(FileData<T>* file, usize ptr, usize num_bytes) {
-    BufferRange range = {};
-
-    if (ptr < file->real_buffer_ptr) {
-      if (ptr + num_bytes <= file->real_buffer_ptr) {
-        //No overlap
-        return {};
-      }
+  void resize_buffer(FileData<T>* file, u32 capacity) {
+    if (capacity == file->buffer_capacity) return;
 
-      range.ptr_start = file->real_buffer_ptr - ptr;
-      range.buffer_start = 0;
+    free_destruct_n<u8>(file->buffer, file->buffer_capacity);
+    file->buffer = allocate_default<u8>(capacity);
+    file->buffer_capacity = capacity;
+    file->buffer_size = 0;
+  }
 
-      usize total_after = file->real_buffer_ptr - (ptr + num_bytes);
-      if (total_after < (usize)file->buffer_size) {
-        range.size = (u32)total_after;
-      }
-      else {
-        range.size = file->buffer_size;
-      }
+  // Call before the buffer is refilled for an access at ptr, the buffer must be in sync
+  template<typename T>
+  void adapt_buffer(FileData<T>* file, usize ptr) {
+    ASSERT(file->in_sync);
+    if (!file->adaptive) return;
+
+    const bool sequential = file->buffer_size > 0
+                         && ptr == file->real_buffer_ptr + file->buffer_size;
+    if (sequential) {
+      resize_buffer(file, static_cast<u32>(smaller<usize>(static_cast<usize>(file->buffer_capacity) * 2,
+                                                           BufferOptions::MAX_SIZE)));
     }
     else {
-      usize buffer_end_ptr = file->real_buffer_ptr + (usize)file->buffer_size;
-      if (buffer_end_ptr <= ptr) {
-        //No overlap
-        return {};
-      }
-
-      range.ptr_start = 0;
-      range.buffer_start = (u32)(ptr - file->real_buffer_ptr);
-
-      if (buffer_end_ptr - ptr < num_bytes) {
-        range.size = (u32)(buffer_end_ptr - ptr);
-      }
-      else {
-        range.size = (u32)num_bytes;
-      }
+      resize_buffer(file, file->base_capacity);
     }
-
-    return range;
   }
 
   template<typename T>
   void small_buffer_read(FileData<T>* const file, usize abstract_ptr, uint8_t* bytes, size_t num_bytes) {
-    ASSERT(num_bytes <= FileData<T>::BUFFER_SIZE);
-    usize space_in_file = file->real_file_size - file->real_buffer_ptr;
-    usize can_read_size = FileData<T>::BUFFER_SIZE > space_in_file ? space_in_file : FileData<T>::BUFFER_SIZE;
+    ASSERT(num_bytes <= file->buffer_capacity);
+    usize space_in_file = file->real_file_size - abstract_ptr;
+    usize can_read_size = smaller<usize>(file->buffer_capacity, space_in_file);
 
     ASSERT(num_bytes <= can_read_size);
 
+    real_seek(file, abstract_ptr);
     handle_read(file->file_handle, file->buffer, can_read_size);
     file->real_file_ptr += can_read_size;
 
@@ -180,21 +232,25 @@ return lit_view_arr(ErrorCodeString :: NAME);
 
   template<typename T>
   void big_buffer_read(FileData<T>* const file, usize abstract_ptr, uint8_t* bytes, size_t num_bytes) {
-    ASSERT(num_bytes > FileData<T>::BUFFER_SIZE);
-    ASSERT(num_bytes <= file->real_file_size - file->real_buffer_ptr);
+    const usize capacity = file->buffer_capacity;
+    ASSERT(num_bytes > capacity);
+    ASSERT(num_bytes <= file->real_file_size - abstract_ptr);
 
+    real_seek(file, abstract_ptr);
     handle_read(file->file_handle, bytes, num_bytes);
     file->real_file_ptr += num_bytes;
 
     //Take the back bits
-    file->real_buffer_ptr = abstract_ptr + (num_bytes - FileData<T>::BUFFER_SIZE);
-    memcpy_s(file->buffer, FileData<T>::BUFFER_SIZE, bytes + (num_bytes - FileData<T>::BUFFER_SIZE), FileData<T>::BUFFER_SIZE);
-    file->buffer_size = FileData<T>::BUFFER_SIZE;
+    file->real_buffer_ptr = abstract_ptr + (num_bytes - capacity);
+    memcpy_s(file->buffer, capacity, bytes + (num_bytes - capacity), capacity);
+    file->buffer_size = (u32)capacity;
   }
 
   template<typename T>
   void generic_buffer_read(FileData<T>* const file, usize abstract_ptr, uint8_t* bytes, size_t num_bytes) {
-    if (num_bytes <= FileData<T>::BUFFER_SIZE) {
+    adapt_buffer(file, abstract_ptr);
+
+    if (num_bytes <= file->buffer_capacity) {
       small_buffer_read(file, abstract_ptr, bytes, num_bytes);
     }
     else {
@@ -204,6 +260,18 @@ return lit_view_arr(ErrorCodeString :: NAME);
 
   template<typename T>
   void write_new_buffer(FileData<T>* const file, const uint8_t* bytes, size_t num_bytes) {
+    adapt_buffer(file, file->abstract_file_ptr);
+
+    if (num_bytes <= file->buffer_capacity) {
+      // Start a new buffer, it reaches the file once it fills up or is synced
+      file->real_buffer_ptr = file->abstract_file_ptr;
+      file->in_sync = false;
+      file->buffer_size = (u32)num_bytes;
+      memcpy_s(file->buffer, num_bytes, bytes, num_bytes);
+      return;
+    }
+
+    real_seek(file, file->abstract_file_ptr);
     handle_write(file->file_handle, bytes, num_bytes);
 
     file->real_file_ptr += num_bytes;
@@ -211,7 +279,7 @@ return lit_view_arr(ErrorCodeString :: NAME);
       file->real_file_size = file->real_file_ptr;
     }
 
-    usize size = num_bytes > FileData<T>::BUFFER_SIZE ? FileData<T>::BUFFER_SIZE : num_bytes;
+    const usize size = file->buffer_capacity;
 
     file->real_buffer_ptr = file->abstract_file_ptr + (num_bytes - size);
     file->in_sync = true;
@@ -226,7 +294,13 @@ return lit_view_arr(ErrorCodeString :: NAME);
   }
 
   template<typename F>
-  FileData<F>::FileData(F h) noexcept : file_handle(h) {
+  FileData<F>::FileData(F h, const BufferOptions& options) noexcept : file_handle(h) {
+    const usize capacity = larger(BufferOptions::MIN_SIZE, smaller(options.size, BufferOptions::MAX_SIZE));
+    adaptive = options.adaptive;
+    base_capacity = static_cast<u32>(capacity);
+    buffer_capacity = base_capacity;
+    buffer = allocate_default<u8>(capacity);
+
     real_file_size = handle_file_size(h);
 
     handle_seek_from_start(h, 0);
@@ -239,6 +313,7 @@ return lit_view_arr(ErrorCodeString :: NAME);
   FileData<T>::~FileData() noexcept {
     sync_buffer(this);
     handle_close(this->file_handle);
+    free_destruct_n<u8>(buffer, buffer_capacity);
   }
 
   template<typename T>
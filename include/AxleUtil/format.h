@@ -209,6 +209,44 @@ namespace Format {
     }
   };
 
+  // Writes nothing, only counts how many chars would have been written
+  struct MeasureFormatter {
+    usize size = 0;
+
+    constexpr void load_string(const char*, usize N) {
+      ASSERT(N > 0);
+      size += N;
+    }
+
+    template<usize N>
+    constexpr void load_string_lit(const char(&str)[N]) {
+      ASSERT(str[N - 1] == '\0');
+      size += N - 1;
+    }
+
+    template<usize N>
+    constexpr void load_string_exact(const char(&)[N]) {
+      size += N;
+    }
+
+    constexpr void null_terminate() {
+      size += 1;
+    }
+
+    constexpr void load_char(char c) {
+      ASSERT(c != '\0');
+      size += 1;
+    }
+  };
+
+  // Exact number of chars format_to would write
+  template<typename ... T>
+  constexpr usize formatted_size(const FormatString<T...>& format, const T& ... ts) {
+    MeasureFormatter measure = {};
+    format_to(measure, format, ts...);
+    return measure.size;
+  }
+
   struct ViewFormatter {
     ViewArr<char> view = {};
     usize capacity = 0;
@@ -275,12 +313,18 @@ struct Viewable<Format::ArrayFormatter> {
 template<typename ... T>
 OwnedArr<char> format(const Format::FormatString<T...>& format, const T& ... ts) {
   AXLE_UTIL_TELEMETRY_FUNCTION();
-  Format::ArrayFormatter result = {};
-  //result.arr.reserve_total(format.len);
 
-  Format::format_to(result, format, ts...);
+  // Two passes: every argument is formatted twice, but the result is allocated once at the
+  // right size and never grown or shrunk. Callers whose destination can grow should format
+  // straight into an ArrayFormatter instead of paying for the measure pass
+  const usize size = Format::formatted_size(format, ts...);
+  OwnedArr<char> result = new_arr<char>(size);
+
+  Format::ViewFormatter view = { view_arr(result) };
+  Format::format_to(view, format, ts...);
+  ASSERT(view.view.size == size);
 
-  return std::move(result).bake();
+  return result;
 }
 
 OwnedArr<char> format_type_set(const ViewArr<const char>& format, size_t prepend_spaces, size_t max_width);
@@ -2,6 +2,7 @@
 #define AXLEUTIL_FORMATTABLE_H_
 
 #include <AxleUtil/safe_lib.h>
+#include <AxleUtil/math.h>
 #include <AxleUtil/stacktrace.h>
 #include <AxleUtil/tracing_wrapper.h>
 
@@ -198,25 +199,58 @@ namespace Format {
     }
   };
 
+  // "00" to "99", so two digits can be written per division
+  inline constexpr char DECIMAL_DIGIT_PAIRS[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
   template<Formatter F>
   constexpr static void load_unsigned(F& res, uint64_t u) {
-    if (u == 0) {
-      return res.load_char('0');
+    if (u < 10) {
+      return res.load_char(static_cast<char>('0' + u));
     }
 
-    constexpr usize MAX = 20;
-    usize i = MAX;
-    char arr[MAX + 1] = {};
+    const usize len = static_cast<usize>(log_10_floor(u)) + 1;
+    char arr[MAX_DECIMAL_U64_DIGITS] = {};
+
+    usize i = len;
+    while (u >= 100) {
+      const usize pair = static_cast<usize>(u % 100) * 2;
+      u /= 100;
+      arr[i - 1] = DECIMAL_DIGIT_PAIRS[pair + 1];
+      arr[i - 2] = DECIMAL_DIGIT_PAIRS[pair];
+      i -= 2;
+    }
 
-    while (u > 0) {
-      ASSERT(i > 0);
-      auto d = u % 10;
-      arr[i - 1] = static_cast<char>('0' + d);
+    if (u >= 10) {
+      const usize pair = static_cast<usize>(u) * 2;
+      arr[i - 1] = DECIMAL_DIGIT_PAIRS[pair + 1];
+      arr[i - 2] = DECIMAL_DIGIT_PAIRS[pair];
+      i -= 2;
+    }
+    else {
+      arr[i - 1] = static_cast<char>('0' + u);
       i -= 1;
-      u /= 10;
     }
 
-    return res.load_string(arr + i, MAX - i);
+    ASSERT(i == 0);
+    return res.load_string(arr, len);
+  }
+
+  // Spreads the 8 nibbles of u into the bytes of the result and converts them to uppercase hex
+  // Byte 0 holds the lowest nibble
+  constexpr u64 hex_digits_swar(u32 u) {
+    u64 x = u;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+
+    // Bit 4 of (nibble + 6) is set only for nibbles >= 10, those need moving up to 'A'
+    const u64 letters = ((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+    return x + 0x3030303030303030ull + (letters * ('A' - '0' - 10));
   }
 
   template<Formatter F>
@@ -227,28 +261,22 @@ namespace Format {
     ASSERT(bytes * 2 <= MAX_LEN);
     ASSERT(bytes >= 1);
 
-    char string_res[2 + MAX_LEN] = {
-      '0', 'x',
-      '0', '0', '0', '0', '0', '0', '0', '0',
-      '0', '0', '0', '0', '0', '0', '0', '0'
-    };
+    char string_res[2 + MAX_LEN] = {};
 
-    usize end_len = 2 + (bytes * 2);
-
-    for (u32 i = 0; i < (end_len - 2); i++) {
-      u8 digit = u & 0xF;
-      u >>= 4;
-
-      if (digit >= 10) {
-        ASSERT(digit < 16);
-        string_res[(end_len - 1) - i] = 'A' + (digit - 10);
-      }
-      else {
-        string_res[(end_len - 1) - i] = '0' + digit;
-      }
+    const u64 high = hex_digits_swar(static_cast<u32>(u >> 32));
+    const u64 low = hex_digits_swar(static_cast<u32>(u));
+    for (usize i = 0; i < 8; ++i) {
+      string_res[2 + 7 - i] = static_cast<char>((high >> (i * 8)) & 0xFF);
+      string_res[2 + 15 - i] = static_cast<char>((low >> (i * 8)) & 0xFF);
     }
 
-    res.load_string(string_res, end_len);
+    // Keep only the requested digits, right next to the prefix
+    const usize digits = bytes * 2;
+    char* const start = string_res + (MAX_LEN - digits);
+    start[0] = '0';
+    start[1] = 'x';
+
+    res.load_string(start, 2 + digits);
   }
 
   template<>
@@ -564,19 +592,62 @@ namespace Format {
     }
   }
 
+  // A literal run of a format string, escaped means it contains "{{" or "}}"
+  // which have to be collapsed when it is written
+  struct FormatSegment {
+    u32 offset = 0;
+    u32 len = 0;
+    bool escaped = false;
+  };
+
+  // Splits str into the literal runs around each "{}"
+  // Must already be a valid format string with N arguments
+  template<usize N>
+  constexpr void build_format_segments(const ViewArr<const char>& str, FormatSegment (&segments)[N + 1]) noexcept {
+    usize segment = 0;
+    usize start = 0;
+    bool escaped = false;
+
+    usize i = 0;
+    while(i < str.size) {
+      if(str[i] == '{' && str[i + 1] == '}') {
+        segments[segment] = { static_cast<u32>(start), static_cast<u32>(i - start), escaped };
+        segment += 1;
+        i += 2;
+        start = i;
+        escaped = false;
+      }
+      else if(str[i] == '{' || str[i] == '}') {
+        escaped = true;
+        i += 2;
+      }
+      else {
+        i += 1;
+      }
+    }
+
+    segments[segment] = { static_cast<u32>(start), static_cast<u32>(str.size - start), escaped };
+  }
+
   template<typename ... Args>
   struct FormatStringRaw {
     ViewArr<const char> str;
 
+    // One literal before each argument and one after the last
+    FormatSegment segments[sizeof...(Args) + 1] = {};
+
     template<usize N>
     consteval FormatStringRaw(const char(&arr)[N]) noexcept : str(lit_view_arr(arr)) {
       assert_valid_format_string<Args...>(str);
+      build_format_segments<sizeof...(Args)>(str, segments);
     }
     consteval FormatStringRaw(const char* arr, usize len) noexcept : str({arr, len}) {
       assert_valid_format_string<Args...>(str);
+      build_format_segments<sizeof...(Args)>(str, segments);
     }
     consteval FormatStringRaw(const ViewArr<const char>& arr) noexcept : str(arr) {
       assert_valid_format_string<Args...>(str);
+      build_format_segments<sizeof...(Args)>(str, segments);
     }
   };
 
@@ -584,72 +655,32 @@ namespace Format {
   using FormatString = FormatStringRaw<Self<Args>...>;
 
   template<Formatter F>
-  struct FormatDispatch {
-    ViewArr<const char> format_string;
-
-    F& result;
-  };
-
-  template<Formatter F, typename T>
-  constexpr FormatDispatch<F>& operator<<(FormatDispatch<F>& f, const T& t) {
-    const char* string = f.format_string.data;
-
-    while (true) {
-      if (f.format_string.size == 0) {
-        format_string_errors::too_many_arguments();
-      }
-      else if(f.format_string[0] == '\0') {
-        format_string_errors::cannot_have_null();
-      }
-      else if (f.format_string[0] == '{') {
-        if(f.format_string.size > 1 && f.format_string[1] == '{') {
-          const std::ptrdiff_t diff = (f.format_string.data + 1) - string;
-          ASSERT(diff >= 0);
-          const usize num_chars = static_cast<usize>(diff);
-          if(num_chars > 0) {
-            f.result.load_string(string, num_chars);
-          }
-
-          f.format_string = view_arr(f.format_string, 2, f.format_string.size - 2);
-          string = f.format_string.data;
-        }
-        else if(f.format_string.size > 1 && f.format_string[1] == '}') {
-          const std::ptrdiff_t diff = f.format_string.data - string;
-          ASSERT(diff >= 0);
-          const usize num_chars = static_cast<usize>(diff);
-          if (num_chars > 0) {
-            f.result.load_string(string, num_chars);
-          }
-
-          FormatArg<T>::load_string(f.result, t);
-
-          f.format_string = view_arr(f.format_string, 2, f.format_string.size - 2);
-          return f;
-        }
-        else {
-          format_string_errors::invalid_open_brace();
-        }
-      }
-      else if(f.format_string[0] == '}') {
-        if(f.format_string.size > 1 && f.format_string[1] == '}') {
-          const std::ptrdiff_t diff = (f.format_string.data + 1) - string;
-          ASSERT(diff >= 0);
-          const usize num_chars = static_cast<usize>(diff);
-          if(num_chars > 0) {
-            f.result.load_string(string, num_chars);
-          }
-
-          f.format_string = view_arr(f.format_string, 2, f.format_string.size - 2);
-          string = f.format_string.data;
-        }
-        else {
-          format_string_errors::invalid_close_brace();
-        }
+  constexpr void load_format_segment(F& result, const ViewArr<const char>& str, const FormatSegment& segment) {
+    if (segment.len == 0) return;
+
+    const char* string = str.data + segment.offset;
+    if (!segment.escaped) {
+      result.load_string(string, segment.len);
+      return;
+    }
+
+    // Write up to and including the first brace of each pair, then skip the second
+    const char* const end = string + segment.len;
+    const char* run = string;
+    while (string < end) {
+      if (string[0] == '{' || string[0] == '}') {
+        result.load_string(run, static_cast<usize>(string - run) + 1);
+        string += 2;
+        run = string;
       }
       else {
-        f.format_string = view_arr(f.format_string, 1, f.format_string.size - 1);
+        string += 1;
       }
     }
+
+    if (run < end) {
+      result.load_string(run, static_cast<usize>(end - run));
+    }
   }
 
   //Doesnt null terminate!
@@ -657,69 +688,10 @@ namespace Format {
   constexpr void format_to(F& result, const FormatString<T...>& format, const T& ... ts) {
     AXLE_UTIL_TELEMETRY_FUNCTION();
 
-    ViewArr<const char> fstr = format.str;
-
-    if constexpr (sizeof...(T) > 0) {
-      FormatDispatch<F> f = { fstr, result };
-
-      (f << ... << ts);
-      fstr = f.format_string;
-    }
-
-    const char* string = fstr.data;
-
-    while (true) {
-      if (fstr.size == 0) {
-        const std::ptrdiff_t diff = fstr.data - string;
-        ASSERT(diff >= 0);
-        const usize num_chars = static_cast<usize>(diff);
-        if (num_chars > 0) {
-          result.load_string(string, num_chars);
-        }
-        return;
-      }
-      else if(fstr[0] == '\0') {
-        format_string_errors::cannot_have_null();
-      }
-      else if (fstr[0] == '{') {
-        if(fstr.size > 1 && fstr[1] == '{') {
-          const std::ptrdiff_t diff = (fstr.data + 1) - string;
-          ASSERT(diff >= 0);
-          const usize num_chars = static_cast<usize>(diff);
-          if(num_chars > 0) {
-            result.load_string(string, num_chars);
-          }
-
-          fstr = view_arr(fstr, 2, fstr.size - 2);
-          string = fstr.data;
-        }
-        else if(fstr.size > 1 && fstr[1] == '}') {
-          format_string_errors::not_enough_arguments();
-        }
-        else {
-          format_string_errors::invalid_open_brace();
-        }
-      }
-      else if(fstr[0] == '}') {
-        if(fstr.size > 1 && fstr[1] == '}') {
-          const std::ptrdiff_t diff = (fstr.data + 1) - string;
-          ASSERT(diff >= 0);
-          const usize num_chars = static_cast<usize>(diff);
-          if(num_chars > 0) {
-            result.load_string(string, num_chars);
-          }
-
-          fstr = view_arr(fstr, 2, fstr.size - 2);
-          string = fstr.data;
-        }
-        else {
-          format_string_errors::invalid_close_brace();
-        }
-      }
-      else {
-        fstr = view_arr(fstr, 1, fstr.size - 1);
-      }
-    }
+    // The string was split up when it was checked, so only the literals and arguments are left to write
+    usize i = 0;
+    ((load_format_segment(result, format.str, format.segments[i]), FormatArg<T>::load_string(result, ts), i += 1), ...);
+    load_format_segment(result, format.str, format.segments[i]);
   }
 }
 }
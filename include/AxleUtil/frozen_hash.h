@@ -0,0 +1,285 @@
+#ifndef AXLEUTIL_FROZEN_HASH_H_
+#define AXLEUTIL_FROZEN_HASH_H_
+
+#include <AxleUtil/strings.h>
+#include <AxleUtil/serialize.h>
+
+#include <bit>
+#include <type_traits>
+
+namespace Axle::Hash {
+// Frozen tables are read in place, so the file byte order has to be the native one
+static_assert(std::endian::native == std::endian::little);
+
+inline constexpr u32 FROZEN_MAGIC = 0x48465841;// "AXFH"
+inline constexpr u32 FROZEN_VERSION = 1;
+inline constexpr u32 FROZEN_EMPTY_SLOT = static_cast<u32>(-1);
+
+// File layout, every offset is from the start of the file:
+// header | u32 slots[slot_count] | FrozenEntry entries[entry_count] | T values[entry_count] | string bytes
+struct FrozenHeader {
+  u32 magic;
+  u32 version;
+  u64 value_size;
+  u64 value_align;
+  u64 slot_count;
+  u64 entry_count;
+  u64 slots_offset;
+  u64 entries_offset;
+  u64 values_offset;
+  u64 strings_offset;
+  u64 total_size;
+};
+
+struct FrozenEntry {
+  u64 hash;
+  u64 string_offset;
+  u64 string_len;
+};
+
+constexpr usize frozen_align(usize v, usize align) {
+  return ((v + align - 1) / align) * align;
+}
+
+constexpr FrozenHeader frozen_layout(usize entry_count, usize string_bytes,
+                                     usize value_size, usize value_align) {
+  FrozenHeader h = {};
+  h.magic = FROZEN_MAGIC;
+  h.version = FROZEN_VERSION;
+  h.value_size = value_size;
+  h.value_align = larger<usize>(value_align, alignof(FrozenEntry));
+
+  // Keep the load under 3/4 so probes stay short
+  h.slot_count = ceil_to_pow_2(larger<usize>(8, ((entry_count * 4) / 3) + 1));
+  h.entry_count = entry_count;
+
+  h.slots_offset = sizeof(FrozenHeader);
+  h.entries_offset = frozen_align(h.slots_offset + h.slot_count * sizeof(u32), alignof(FrozenEntry));
+  h.values_offset = frozen_align(h.entries_offset + h.entry_count * sizeof(FrozenEntry), h.value_align);
+  h.strings_offset = h.values_offset + h.entry_count * h.value_size;
+  h.total_size = h.strings_offset + string_bytes;
+  return h;
+}
+
+// Writes table in the frozen format
+// Values are copied byte for byte so have to be trivially copyable
+template<typename T, typename S>
+void freeze_hash_table(Serializer<S, ByteOrder::LittleEndian>& ser, const InternHashTable<T>& table) {
+  static_assert(std::is_trivially_copyable_v<T>, "Frozen values are read in place without parsing");
+  using Trait = DefaultHashmapTrait<const InternString*>;
+
+  const InternString* const* keys = table.key_arr();
+  const auto* vals = table.val_arr();
+
+  usize string_bytes = 0;
+  for (usize i = 0; i < table.el_capacity; ++i) {
+    const InternString* key = keys[i];
+    if (Trait::eq(key, Trait::EMPTY) || Trait::eq(key, Trait::TOMBSTONE)) continue;
+
+    string_bytes += key->len;
+  }
+
+  const FrozenHeader h = frozen_layout(table.used, string_bytes, sizeof(T), alignof(T));
+  ASSERT(h.entry_count < static_cast<usize>(FROZEN_EMPTY_SLOT));
+
+  OwnedArr<u32> slots = new_arr<u32>(h.slot_count);
+  FOR_MUT(slots, it) {
+    *it = FROZEN_EMPTY_SLOT;
+  }
+
+  // Entries keep the order of the source table
+  {
+    const usize mask = h.slot_count - 1;
+    u32 entry = 0;
+    for (usize i = 0; i < table.el_capacity; ++i) {
+      const InternString* key = keys[i];
+      if (Trait::eq(key, Trait::EMPTY) || Trait::eq(key, Trait::TOMBSTONE)) continue;
+
+      usize index = key->hash & mask;
+      while (slots[index] != FROZEN_EMPTY_SLOT) {
+        index = (index + 1) & mask;
+      }
+      slots[index] = entry;
+      entry += 1;
+    }
+    ASSERT(entry == h.entry_count);
+  }
+
+  usize written = 0;
+  const auto write_u32 = [&](u32 u) { serialize_le(ser, u); written += 4; };
+  const auto write_u64 = [&](u64 u) { serialize_le(ser, u); written += 8; };
+  const auto pad_to = [&](usize offset) {
+    ASSERT(written <= offset);
+    serialize_le(ser, SerializeZeros{ offset - written });
+    written = offset;
+  };
+
+  write_u32(h.magic);
+  write_u32(h.version);
+  write_u64(h.value_size);
+  write_u64(h.value_align);
+  write_u64(h.slot_count);
+  write_u64(h.entry_count);
+  write_u64(h.slots_offset);
+  write_u64(h.entries_offset);
+  write_u64(h.values_offset);
+  write_u64(h.strings_offset);
+  write_u64(h.total_size);
+  ASSERT(written == h.slots_offset);
+
+  FOR(slots, it) {
+    write_u32(*it);
+  }
+
+  pad_to(h.entries_offset);
+  {
+    usize string_offset = h.strings_offset;
+    for (usize i = 0; i < table.el_capacity; ++i) {
+      const InternString* key = keys[i];
+      if (Trait::eq(key, Trait::EMPTY) || Trait::eq(key, Trait::TOMBSTONE)) continue;
+
+      write_u64(key->hash);
+      write_u64(string_offset);
+      write_u64(key->len);
+      string_offset += key->len;
+    }
+  }
+
+  pad_to(h.values_offset);
+  for (usize i = 0; i < table.el_capacity; ++i) {
+    const InternString* key = keys[i];
+    if (Trait::eq(key, Trait::EMPTY) || Trait::eq(key, Trait::TOMBSTONE)) continue;
+
+    const u8* bytes = reinterpret_cast<const u8*>(&vals[i].val);
+    ser.write_bytes(ViewArr<const u8>{ bytes, sizeof(T) });
+    written += sizeof(T);
+  }
+
+  ASSERT(written == h.strings_offset);
+  for (usize i = 0; i < table.el_capacity; ++i) {
+    const InternString* key = keys[i];
+    if (Trait::eq(key, Trait::EMPTY) || Trait::eq(key, Trait::TOMBSTONE)) continue;
+
+    ser.write_bytes(ViewArr<const u8>{ reinterpret_cast<const u8*>(key->string), key->len });
+    written += key->len;
+  }
+
+  ASSERT(written == h.total_size);
+}
+
+// Read only view over a frozen table, usually straight out of a mapped file
+// Nothing is copied or rehashed, lookups read the bytes in place
+template<typename T>
+struct FrozenHashTable {
+  const u8* base = nullptr;
+  const FrozenHeader* header = nullptr;
+  const u32* slots = nullptr;
+  const FrozenEntry* entries = nullptr;
+  const T* values = nullptr;
+  const char* strings = nullptr;
+
+  // Checks the header, that each section fits inside bytes, and every slot and entry
+  // so nothing read through the table can be out of bounds and missed lookups always end
+  // bytes has to outlive the table
+  bool load(const ViewArr<const u8>& bytes) {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    if (bytes.size < sizeof(FrozenHeader)) return false;
+    if (reinterpret_cast<uintptr_t>(bytes.data) % alignof(FrozenHeader) != 0) return false;
+
+    const FrozenHeader* h = reinterpret_cast<const FrozenHeader*>(bytes.data);
+    if (h->magic != FROZEN_MAGIC || h->version != FROZEN_VERSION) return false;
+    if (h->value_size != sizeof(T) || h->value_align < alignof(T)) return false;
+    if (h->total_size > bytes.size) return false;
+    if (h->slot_count == 0 || (h->slot_count & (h->slot_count - 1)) != 0) return false;
+    if (reinterpret_cast<uintptr_t>(bytes.data) % h->value_align != 0) return false;
+    if (h->entry_count >= static_cast<u64>(FROZEN_EMPTY_SLOT)) return false;
+    if (h->strings_offset > h->total_size) return false;
+
+    const FrozenHeader expected = frozen_layout(h->entry_count,
+                                                h->total_size - h->strings_offset,
+                                                sizeof(T), alignof(T));
+    if (h->slot_count != expected.slot_count
+        || h->slots_offset != expected.slots_offset
+        || h->entries_offset != expected.entries_offset
+        || h->values_offset != expected.values_offset
+        || h->strings_offset != expected.strings_offset) {
+      return false;
+    }
+
+    const u32* file_slots = reinterpret_cast<const u32*>(bytes.data + h->slots_offset);
+    usize used_slots = 0;
+    for (usize i = 0; i < h->slot_count; ++i) {
+      const u32 entry = file_slots[i];
+      if (entry == FROZEN_EMPTY_SLOT) continue;
+      if (entry >= h->entry_count) return false;
+      used_slots += 1;
+    }
+
+    // The layout always has more slots than entries, so this leaves an empty slot to end probes
+    if (used_slots != h->entry_count) return false;
+
+    const FrozenEntry* file_entries = reinterpret_cast<const FrozenEntry*>(bytes.data + h->entries_offset);
+    for (usize i = 0; i < h->entry_count; ++i) {
+      const FrozenEntry& e = file_entries[i];
+      if (e.string_offset < h->strings_offset || e.string_offset > h->total_size) return false;
+      if (e.string_len > h->total_size - e.string_offset) return false;
+    }
+
+    base = bytes.data;
+    header = h;
+    slots = reinterpret_cast<const u32*>(base + h->slots_offset);
+    entries = reinterpret_cast<const FrozenEntry*>(base + h->entries_offset);
+    values = reinterpret_cast<const T*>(base + h->values_offset);
+    strings = reinterpret_cast<const char*>(base);
+    return true;
+  }
+
+  constexpr bool is_loaded() const noexcept {
+    return header != nullptr;
+  }
+
+  usize size() const noexcept {
+    return header == nullptr ? 0 : static_cast<usize>(header->entry_count);
+  }
+
+  ViewArr<const char> key_at(usize i) const {
+    ASSERT(i < size());
+    return { strings + entries[i].string_offset, static_cast<usize>(entries[i].string_len) };
+  }
+
+  const T& val_at(usize i) const {
+    ASSERT(i < size());
+    return values[i];
+  }
+
+  const T* get_val(const char* str, usize len, u64 hash) const {
+    if (header == nullptr) return nullptr;
+
+    const usize mask = static_cast<usize>(header->slot_count) - 1;
+    usize index = hash & mask;
+    while (true) {
+      const u32 entry = slots[index];
+      if (entry == FROZEN_EMPTY_SLOT) return nullptr;
+
+      const FrozenEntry& e = entries[entry];
+      if (e.hash == hash && e.string_len == len
+          && memeq_ts<char>(strings + e.string_offset, str, len)) {
+        return values + entry;
+      }
+
+      index = (index + 1) & mask;
+    }
+  }
+
+  const T* get_val(const ViewArr<const char>& str) const {
+    return get_val(str.data, str.size, fnv1a_hash(str.data, str.size));
+  }
+
+  const T* get_val(const InternString* str) const {
+    return get_val(str->string, str->len, str->hash);
+  }
+};
+}
+
+#endif
@@ -2,6 +2,12 @@
 #define AXLEUTIL_HASH_H_
 
 #include <AxleUtil/memory.h>
+#include <AxleUtil/formattable.h>
+
+#ifdef AXLE_HASH_STATS
+#include <chrono>
+#include <typeinfo>
+#endif
 
 namespace Axle::Hash {
 template<typename T>
@@ -21,6 +27,119 @@ concept ValidInternalTrait = requires {
 template<typename T>
 struct DefaultHashmapTrait;
 
+// Batched operations hash and prefetch this many keys before probing any of them
+inline constexpr usize BATCH_PREFETCH_WINDOW = 16;
+
+// Snapshot of a tables health, collected by scanning it
+struct HashTableStats {
+  constexpr static usize PROBE_HISTOGRAM_SIZE = 16;
+
+  usize capacity = 0;
+  usize used = 0;
+  usize tombstones = 0;
+
+  // probe_histogram[i] = number of keys found after i + 1 probes
+  // the last entry also counts every longer probe
+  usize probe_histogram[PROBE_HISTOGRAM_SIZE] = {};
+  usize probe_total = 0;
+  usize probe_max = 0;
+
+  // Only counted when built with AXLE_HASH_STATS
+  usize resize_count = 0;
+  u64 resize_time_ns = 0;
+
+  constexpr void add_probe(usize index, usize home_index) noexcept {
+    const usize length = (index >= home_index)
+      ? (index - home_index) + 1
+      : (index + capacity - home_index) + 1;
+
+    probe_histogram[smaller(length, PROBE_HISTOGRAM_SIZE) - 1] += 1;
+    probe_total += length;
+    probe_max = larger(probe_max, length);
+  }
+
+  constexpr float load_factor() const noexcept {
+    if (capacity == 0) return 0.0f;
+    return static_cast<float>(used) / static_cast<float>(capacity);
+  }
+
+  constexpr float tombstone_ratio() const noexcept {
+    if (capacity == 0) return 0.0f;
+    return static_cast<float>(tombstones) / static_cast<float>(capacity);
+  }
+
+  constexpr float probe_mean() const noexcept {
+    if (used == 0) return 0.0f;
+    return static_cast<float>(probe_total) / static_cast<float>(used);
+  }
+};
+
+#ifdef AXLE_HASH_STATS
+struct ResizeStats {
+  usize count = 0;
+  u64 time_ns = 0;
+};
+
+struct ResizeTimer {
+  ResizeStats& stats;
+  std::chrono::steady_clock::time_point start;
+
+  ResizeTimer(ResizeStats& s) noexcept
+    : stats(s), start(std::chrono::steady_clock::now()) {}
+
+  ~ResizeTimer() {
+    const auto end = std::chrono::steady_clock::now();
+    stats.count += 1;
+    stats.time_ns += static_cast<u64>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  }
+};
+
+#define AXLE_HASH_RESIZE_TIMER(stats) ::Axle::Hash::ResizeTimer _hash_resize_timer{ stats }
+
+struct LiveTable {
+  LiveTable* prev = nullptr;
+  LiveTable* next = nullptr;
+
+  const char* type_name = nullptr;
+  const void* table = nullptr;
+  HashTableStats(*collect)(const void*) = nullptr;
+};
+
+void register_live_table(LiveTable* t) noexcept;
+void unregister_live_table(LiveTable* t) noexcept;
+
+// Keeps a table in the live table list for as long as it exists
+template<typename Table>
+struct LiveTableRegistration : LiveTable {
+  LiveTableRegistration(const Table* t) noexcept {
+    type_name = typeid(Table).name();
+    table = t;
+    collect = [](const void* p) -> HashTableStats {
+      return static_cast<const Table*>(p)->stats();
+    };
+
+    register_live_table(this);
+  }
+
+  ~LiveTableRegistration() {
+    unregister_live_table(this);
+  }
+
+  LiveTableRegistration(const LiveTableRegistration&) = delete;
+  LiveTableRegistration(LiveTableRegistration&&) = delete;
+  LiveTableRegistration& operator=(const LiveTableRegistration&) = delete;
+  LiveTableRegistration& operator=(LiveTableRegistration&&) = delete;
+};
+#else
+#define AXLE_HASH_RESIZE_TIMER(stats) ((void)0)
+#endif
+
+// Prints the stats of every live table to stderr
+// Nothing is dumped automatically at exit, call this before leaving main to see every table
+// Does nothing unless built with AXLE_HASH_STATS
+void dump_live_table_stats();
+
 template<typename T, ValidInternalTrait Trait = DefaultHashmapTrait<T>>
 struct InternalHashSet {
   constexpr static float LOAD_FACTOR = 0.75;
@@ -32,6 +151,11 @@ struct InternalHashSet {
   usize el_capacity = 0;
   usize used = 0;
 
+#ifdef AXLE_HASH_STATS
+  ResizeStats resize_stats = {};
+  LiveTableRegistration<InternalHashSet> live_registration{ this };
+#endif
+
   constexpr bool needs_resize(usize extra) const {
     return static_cast<usize>(static_cast<float>(el_capacity) * LOAD_FACTOR) <= (used + extra);
   }
@@ -43,6 +167,9 @@ struct InternalHashSet {
     data(std::exchange(t.data, nullptr)),
     el_capacity(std::exchange(t.el_capacity, 0u)),
     used(std::exchange(t.used, 0u))
+#ifdef AXLE_HASH_STATS
+    , resize_stats(std::exchange(t.resize_stats, {}))
+#endif
   {}
 
   constexpr InternalHashSet& operator=(InternalHashSet&& t) {
@@ -51,6 +178,9 @@ struct InternalHashSet {
     data = std::exchange(t.data, nullptr);
     el_capacity = std::exchange(t.el_capacity, 0u);
     used = std::exchange(t.used, 0u);
+#ifdef AXLE_HASH_STATS
+    resize_stats = std::exchange(t.resize_stats, {});
+#endif
 
     return *this;
   }
@@ -60,11 +190,18 @@ struct InternalHashSet {
   InternalHashSet& operator=(const InternalHashSet&) = delete;
 
   bool contains(const param_t key) const;
+  bool contains_at(const param_t key, usize start_index) const;
   value_t& internal_get(const param_t key) const;
+  value_t& internal_get_at(const param_t key, usize start_index) const;
   value_t get(const param_t key) const;
   void try_extend(usize num);
   void insert(const param_t key);
   void remove(const param_t key);
+
+  void contains_batch(const ViewArr<const value_t>& keys, const ViewArr<bool>& out) const;
+  void insert_batch(const ViewArr<const value_t>& keys);
+
+  HashTableStats stats() const;
 };
 
 inline constexpr usize INVALID_SOA_INDEX = static_cast<usize>(-1);
@@ -100,6 +237,11 @@ struct InternalHashTable {
   usize el_capacity = 0;
   usize used = 0;
 
+#ifdef AXLE_HASH_STATS
+  ResizeStats resize_stats = {};
+  LiveTableRegistration<InternalHashTable> live_registration{ this };
+#endif
+
   constexpr bool needs_resize(size_t extra) const noexcept {
     return static_cast<usize>(static_cast<float>(el_capacity) * LOAD_FACTOR) <= (used + extra);
   }
@@ -139,6 +281,9 @@ struct InternalHashTable {
     data(std::exchange(t.data, nullptr)),
     el_capacity(std::exchange(t.el_capacity, 0u)),
     used(std::exchange(t.used, 0u))
+#ifdef AXLE_HASH_STATS
+    , resize_stats(std::exchange(t.resize_stats, {}))
+#endif
   {}
 
   constexpr InternalHashTable& operator=(InternalHashTable&& t) {
@@ -147,6 +292,9 @@ struct InternalHashTable {
     data = std::exchange(t.data, nullptr);
     el_capacity = std::exchange(t.el_capacity, 0u);
     used = std::exchange(t.used, 0u);
+#ifdef AXLE_HASH_STATS
+    resize_stats = std::exchange(t.resize_stats, {});
+#endif
 
     return *this;
   }
@@ -176,6 +324,15 @@ struct InternalHashTable {
   template<usize N>
   ConstArray<T*, N> get_or_create_multiple(const param_t (&arr)[N]) requires requires(T t) { {T()}->IS_SAME_TYPE<T>; };
 
+  SoaIndex get_contains_soa_index_at(const param_t key, usize first_index) const;
+  usize get_insert_soa_index_at(const param_t key, usize first_index) const;
+
+  // out[i] = get_val(keys[i]), but with the home buckets prefetched ahead of probing
+  void get_val_batch(const ViewArr<const value_t>& keys, const ViewArr<T*>& out) const;
+  void get_or_create_batch(const ViewArr<const value_t>& keys, const ViewArr<T*>& out) requires requires(T t) { {T()}->IS_SAME_TYPE<T>; };
+
+  HashTableStats stats() const;
+
   struct Iterator {
     InternalHashTable<K, T, Trait>* table;
     usize i;
@@ -239,8 +396,12 @@ bool InternalHashSet<T, Trait>::contains(const param_t key) const {
       && !Trait::eq(key, Trait::TOMBSTONE));
   if(el_capacity == 0) return false;
 
-  const usize start_index = Trait::hash(key) % el_capacity;
+  return contains_at(key, Trait::hash(key) % el_capacity);
+}
 
+template<typename T, ValidInternalTrait Trait>
+bool InternalHashSet<T, Trait>::contains_at(const param_t key, const usize start_index) const {
+  ASSERT(el_capacity > 0);
   usize index = start_index;
   do {
     value_t& test_key = data[index];
@@ -260,11 +421,14 @@ bool InternalHashSet<T, Trait>::contains(const param_t key) const {
 
 template<typename T, ValidInternalTrait Trait>
 typename InternalHashSet<T, Trait>::value_t& InternalHashSet<T, Trait>::internal_get(const param_t s_key) const {
+  return internal_get_at(s_key, Trait::hash(s_key) % el_capacity);
+}
+
+template<typename T, ValidInternalTrait Trait>
+typename InternalHashSet<T, Trait>::value_t& InternalHashSet<T, Trait>::internal_get_at(const param_t s_key, const usize start_index) const {
   bool found_tombstone = false;
   usize tombstone_index = 0;
 
-  const usize start_index = Trait::hash(s_key) % el_capacity;
-
   usize index = start_index;
   do {
     value_t& test_key = data[index];
@@ -300,12 +464,22 @@ typename InternalHashSet<T, Trait>::value_t InternalHashSet<T, Trait>::get(const
 template<typename T, ValidInternalTrait Trait>
 void InternalHashSet<T, Trait>::try_extend(usize num) {
   if (needs_resize(num)) {
+    AXLE_HASH_RESIZE_TIMER(resize_stats);
+
     value_t* old_data = data;
     const usize old_el_cap = el_capacity;
 
-    do {
-      el_capacity <<= 1;
-    } while (needs_resize(num));
+    if (el_capacity == 0) {
+      el_capacity = 8;
+      while (needs_resize(num)) {
+        el_capacity <<= 1;
+      }
+    }
+    else {
+      do {
+        el_capacity <<= 1;
+      } while (needs_resize(num));
+    }
 
     data = allocate_default<value_t>(el_capacity);
 
@@ -371,6 +545,102 @@ void InternalHashSet<T, Trait>::remove(const param_t key) {
   used -= 1;
 }
 
+template<typename T, ValidInternalTrait Trait>
+void InternalHashSet<T, Trait>::contains_batch(const ViewArr<const value_t>& keys, const ViewArr<bool>& out) const {
+  ASSERT(keys.size == out.size);
+
+  if (el_capacity == 0) {
+    FOR_MUT(out, it) {
+      *it = false;
+    }
+    return;
+  }
+
+  usize starts[BATCH_PREFETCH_WINDOW];
+
+  for (usize base = 0; base < keys.size; base += BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(keys.size - base, BATCH_PREFETCH_WINDOW);
+
+    for (usize i = 0; i < count; ++i) {
+      const value_t& key = keys[base + i];
+      ASSERT(!Trait::eq(key, Trait::EMPTY)
+          && !Trait::eq(key, Trait::TOMBSTONE));
+
+      starts[i] = Trait::hash(key) % el_capacity;
+      prefetch_read(data + starts[i]);
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      out[base + i] = contains_at(keys[base + i], starts[i]);
+    }
+  }
+}
+
+template<typename T, ValidInternalTrait Trait>
+void InternalHashSet<T, Trait>::insert_batch(const ViewArr<const value_t>& keys) {
+  if (keys.size == 0) return;
+
+  // Reserve for every key up front so nothing moves while the batch is probed
+  if (needs_resize(keys.size)) {
+    try_extend(keys.size);
+  }
+
+  usize starts[BATCH_PREFETCH_WINDOW];
+
+  for (usize base = 0; base < keys.size; base += BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(keys.size - base, BATCH_PREFETCH_WINDOW);
+
+    for (usize i = 0; i < count; ++i) {
+      const value_t& key = keys[base + i];
+      ASSERT(!Trait::eq(key, Trait::EMPTY)
+          && !Trait::eq(key, Trait::TOMBSTONE));
+
+      starts[i] = Trait::hash(key) % el_capacity;
+      prefetch_read(data + starts[i]);
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      const value_t& key = keys[base + i];
+      value_t& loc = internal_get_at(key, starts[i]);
+      if (Trait::eq(key, loc)) continue;//already contained
+
+      ASSERT(Trait::eq(loc, Trait::EMPTY)
+          || Trait::eq(loc, Trait::TOMBSTONE));
+
+      loc = value_t(key);
+      used += 1;
+    }
+  }
+
+  ASSERT(!needs_resize(0));
+}
+
+template<typename T, ValidInternalTrait Trait>
+HashTableStats InternalHashSet<T, Trait>::stats() const {
+  HashTableStats s = {};
+  s.capacity = el_capacity;
+  s.used = used;
+
+  for (usize i = 0; i < el_capacity; ++i) {
+    const value_t& key = data[i];
+    if (Trait::eq(key, Trait::EMPTY)) continue;
+
+    if (Trait::eq(key, Trait::TOMBSTONE)) {
+      s.tombstones += 1;
+    }
+    else {
+      s.add_probe(i, Trait::hash(key) % el_capacity);
+    }
+  }
+
+#ifdef AXLE_HASH_STATS
+  s.resize_count = resize_stats.count;
+  s.resize_time_ns = resize_stats.time_ns;
+#endif
+
+  return s;
+}
+
 template<typename K, typename T, ValidInternalTrait Trait>
 InternalHashTable<K, T, Trait>::~InternalHashTable() {
   ASSERT(ensure_invariants());
@@ -408,9 +678,13 @@ typename InternalHashTable<K, T, Trait>::SoaIndex InternalHashTable<K, T, Trait>
       && !Trait::eq(key, Trait::TOMBSTONE));
   if (el_capacity == 0) return { INVALID_SOA_INDEX };
 
-  const value_t* keys = key_arr();
+  return get_contains_soa_index_at(key, Trait::hash(key) % el_capacity);
+}
 
-  const usize first_index = Trait::hash(key) % el_capacity;
+template<typename K, typename T, ValidInternalTrait Trait>
+typename InternalHashTable<K, T, Trait>::SoaIndex InternalHashTable<K, T, Trait>::get_contains_soa_index_at(const param_t key, const usize first_index) const {
+  ASSERT(el_capacity > 0);
+  const value_t* keys = key_arr();
 
   usize index = first_index;
   do {
@@ -434,12 +708,17 @@ usize InternalHashTable<K, T, Trait>::get_insert_soa_index(const param_t key) co
   ASSERT(ensure_invariants());
   ASSERT(!Trait::eq(key, Trait::EMPTY)
       && !Trait::eq(key, Trait::TOMBSTONE));
+
+  return get_insert_soa_index_at(key, Trait::hash(key) % el_capacity);
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+usize InternalHashTable<K, T, Trait>::get_insert_soa_index_at(const param_t key, const usize first_index) const {
   const value_t* const keys = key_arr();
 
   bool found_tombstone = false;
   usize tombstone_index = 0;
 
-  const usize first_index = Trait::hash(key) % el_capacity;
   usize index = first_index;
 
   bool debug_found_empty = false;
@@ -480,6 +759,7 @@ template<typename K, typename T, ValidInternalTrait Trait>
 void InternalHashTable<K, T, Trait>::try_extend(size_t num) {
   ASSERT(ensure_invariants());
   ASSERT(needs_resize(num));
+  AXLE_HASH_RESIZE_TIMER(resize_stats);
 
   uint8_t* old_data = data;
   const size_t old_el_cap = el_capacity;
@@ -736,6 +1016,131 @@ ConstArray<T*, N> InternalHashTable<K, T, Trait>::get_or_create_multiple(const p
   }
 }
 
+template<typename K, typename T, ValidInternalTrait Trait>
+void InternalHashTable<K, T, Trait>::get_val_batch(const ViewArr<const value_t>& keys, const ViewArr<T*>& out) const {
+  ASSERT(ensure_invariants());
+  ASSERT(keys.size == out.size);
+
+  if (el_capacity == 0) {
+    FOR_MUT(out, it) {
+      *it = nullptr;
+    }
+    return;
+  }
+
+  const value_t* const key_data = key_arr();
+  const val_storage_t* const val_data = val_arr();
+
+  usize starts[BATCH_PREFETCH_WINDOW];
+
+  for (usize base = 0; base < keys.size; base += BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(keys.size - base, BATCH_PREFETCH_WINDOW);
+
+    for (usize i = 0; i < count; ++i) {
+      const value_t& key = keys[base + i];
+      ASSERT(!Trait::eq(key, Trait::EMPTY)
+          && !Trait::eq(key, Trait::TOMBSTONE));
+
+      starts[i] = Trait::hash(key) % el_capacity;
+      prefetch_read(key_data + starts[i]);
+      prefetch_read(val_data + starts[i]);
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      const SoaIndex index = get_contains_soa_index_at(keys[base + i], starts[i]);
+      out[base + i] = index.is_valid() ? &get_val(index) : nullptr;
+    }
+  }
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+void InternalHashTable<K, T, Trait>::get_or_create_batch(const ViewArr<const value_t>& keys, const ViewArr<T*>& out) requires requires(T t) { {T()}->IS_SAME_TYPE<T>; }
+{
+  ASSERT(ensure_invariants());
+  ASSERT(keys.size == out.size);
+
+  get_val_batch(keys, out);
+
+  usize unfound_count = 0;
+  FOR(out, it) {
+    unfound_count += (*it == nullptr);
+  }
+
+  if (unfound_count == 0) return;
+
+  // Resizing moves every value so all of the found pointers need redoing
+  const bool resized = needs_resize(unfound_count);
+  if (resized) {
+    try_extend(unfound_count);
+  }
+
+  value_t* const key_data = key_arr();
+  val_storage_t* const val_data = val_arr();
+
+  usize starts[BATCH_PREFETCH_WINDOW];
+
+  for (usize base = 0; base < keys.size; base += BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(keys.size - base, BATCH_PREFETCH_WINDOW);
+
+    for (usize i = 0; i < count; ++i) {
+      if (!resized && out[base + i] != nullptr) continue;
+
+      starts[i] = Trait::hash(keys[base + i]) % el_capacity;
+      prefetch_read(key_data + starts[i]);
+      prefetch_read(val_data + starts[i]);
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      if (!resized && out[base + i] != nullptr) continue;
+
+      const value_t& key = keys[base + i];
+      const usize soa_index = get_insert_soa_index_at(key, starts[i]);
+
+      value_t& test_key = key_data[soa_index];
+      val_storage_t& val = val_data[soa_index];
+
+      if (!Trait::eq(key, test_key)) {
+        ASSERT(Trait::eq(Trait::EMPTY, test_key)
+            || Trait::eq(Trait::TOMBSTONE, test_key));
+        test_key = key;
+        val.val = T();
+        used += 1;
+      }
+
+      out[base + i] = &val.val;
+    }
+  }
+
+  ASSERT(ensure_invariants());
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+HashTableStats InternalHashTable<K, T, Trait>::stats() const {
+  HashTableStats s = {};
+  s.capacity = el_capacity;
+  s.used = used;
+
+  const value_t* const keys = key_arr();
+  for (usize i = 0; i < el_capacity; ++i) {
+    const value_t& key = keys[i];
+    if (Trait::eq(key, Trait::EMPTY)) continue;
+
+    if (Trait::eq(key, Trait::TOMBSTONE)) {
+      s.tombstones += 1;
+    }
+    else {
+      s.add_probe(i, Trait::hash(key) % el_capacity);
+    }
+  }
+
+#ifdef AXLE_HASH_STATS
+  s.resize_count = resize_stats.count;
+  s.resize_time_ns = resize_stats.time_ns;
+#endif
+
+  return s;
+}
+
 template<typename K, typename T, ValidInternalTrait Trait>
 void InternalHashTable<K, T, Trait>::remove(const param_t key) {
   SoaIndex s = get_contains_soa_index(key);
@@ -776,6 +1181,420 @@ T InternalHashTable<K, T, Trait>::take(const SoaIndex s) {
   return t;
 }
 
+// Hash table where the probe array only holds indices into packed key and value arrays
+// Iteration is a linear scan of the packed arrays in insertion order
+// Removal swaps the last entry into the gap, which is the only thing that reorders entries
+// T must be default constructible as the packed arrays are allocated up front
+template<typename K, typename T, ValidInternalTrait Trait = DefaultHashmapTrait<K>>
+struct DenseHashTable {
+  constexpr static float LOAD_FACTOR = 0.75;
+  constexpr static u32 EMPTY_INDEX = static_cast<u32>(-1);
+  constexpr static u32 TOMBSTONE_INDEX = static_cast<u32>(-2);
+
+  using value_t = typename Trait::value_t;
+  using param_t = typename Trait::param_t;
+
+  u32* slots = nullptr;
+  usize slot_capacity = 0;// always a power of 2
+  usize tombstones = 0;
+
+  value_t* keys = nullptr;
+  T* values = nullptr;
+  usize el_capacity = 0;
+  usize used = 0;
+
+#ifdef AXLE_HASH_STATS
+  ResizeStats resize_stats = {};
+  LiveTableRegistration<DenseHashTable> live_registration{ this };
+#endif
+
+  // Tombstones still lengthen probes so they count towards the load
+  constexpr bool needs_resize(usize extra) const noexcept {
+    return static_cast<usize>(static_cast<float>(slot_capacity) * LOAD_FACTOR) <= (used + tombstones + extra);
+  }
+
+  constexpr usize home_index(u64 hash) const noexcept {
+    return static_cast<usize>(hash) & (slot_capacity - 1);
+  }
+
+  constexpr DenseHashTable() = default;
+  ~DenseHashTable();
+
+  constexpr DenseHashTable(DenseHashTable&& t) :
+    slots(std::exchange(t.slots, nullptr)),
+    slot_capacity(std::exchange(t.slot_capacity, 0u)),
+    tombstones(std::exchange(t.tombstones, 0u)),
+    keys(std::exchange(t.keys, nullptr)),
+    values(std::exchange(t.values, nullptr)),
+    el_capacity(std::exchange(t.el_capacity, 0u)),
+    used(std::exchange(t.used, 0u))
+#ifdef AXLE_HASH_STATS
+    , resize_stats(std::exchange(t.resize_stats, {}))
+#endif
+  {}
+
+  constexpr DenseHashTable& operator=(DenseHashTable&& t) {
+    if (this == &t) return *this;
+
+    free_no_destruct<u32>(slots);
+    free_destruct_n<value_t>(keys, el_capacity);
+    free_destruct_n<T>(values, el_capacity);
+
+    slots = std::exchange(t.slots, nullptr);
+    slot_capacity = std::exchange(t.slot_capacity, 0u);
+    tombstones = std::exchange(t.tombstones, 0u);
+    keys = std::exchange(t.keys, nullptr);
+    values = std::exchange(t.values, nullptr);
+    el_capacity = std::exchange(t.el_capacity, 0u);
+    used = std::exchange(t.used, 0u);
+#ifdef AXLE_HASH_STATS
+    resize_stats = std::exchange(t.resize_stats, {});
+#endif
+
+    return *this;
+  }
+
+  DenseHashTable(const DenseHashTable&) = delete;
+  DenseHashTable& operator=(const DenseHashTable&) = delete;
+
+  // Slot holding the index of key, or nullptr
+  u32* find_slot(const param_t key) const;
+  // Slot holding the index of key, otherwise the first free slot
+  u32* find_insert_slot(const param_t key) const;
+  void try_extend(usize num);
+
+  bool contains(const param_t key) const;
+  T* get_val(const param_t key) const;
+  void insert(const param_t key, T&& val);
+  T* get_or_create(const param_t key);
+
+  void remove(const param_t key);
+  T take(const param_t key);
+
+  constexpr ViewArr<const value_t> key_view() const noexcept { return { keys, used }; }
+  constexpr ViewArr<const T> value_view() const noexcept { return { values, used }; }
+  constexpr ViewArr<T> value_view() noexcept { return { values, used }; }
+
+  HashTableStats stats() const;
+
+  // Values are only mutable when iterating a mutable table
+  template<bool IS_CONST>
+  struct IteratorT {
+    using table_t = std::conditional_t<IS_CONST, const DenseHashTable<K, T, Trait>, DenseHashTable<K, T, Trait>>;
+    using val_t = std::conditional_t<IS_CONST, const T, T>;
+
+    table_t* table;
+    usize i;
+
+    value_t key() const {
+      if (!is_valid()) return Trait::EMPTY;
+      return table->keys[i];
+    }
+    val_t* val() const {
+      if (!is_valid()) return nullptr;
+      return table->values + i;
+    }
+
+    constexpr bool is_valid() const {
+      return table != nullptr && i < table->used;
+    }
+
+    void next() {
+      i += 1;
+    }
+  };
+
+  using Iterator = IteratorT<false>;
+  using ConstIterator = IteratorT<true>;
+
+  Iterator itr() {
+    return Iterator{ this, 0 };
+  }
+
+  ConstIterator itr() const {
+    return ConstIterator{ this, 0 };
+  }
+
+private:
+  u32 take_index(u32* slot);
+};
+
+template<typename K, typename T, ValidInternalTrait Trait>
+DenseHashTable<K, T, Trait>::~DenseHashTable() {
+  free_no_destruct<u32>(slots);
+  free_destruct_n<value_t>(keys, el_capacity);
+  free_destruct_n<T>(values, el_capacity);
+
+  slots = nullptr;
+  slot_capacity = 0;
+  tombstones = 0;
+  keys = nullptr;
+  values = nullptr;
+  el_capacity = 0;
+  used = 0;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+u32* DenseHashTable<K, T, Trait>::find_slot(const param_t key) const {
+  ASSERT(!Trait::eq(key, Trait::EMPTY)
+      && !Trait::eq(key, Trait::TOMBSTONE));
+  if (slot_capacity == 0) return nullptr;
+
+  const usize mask = slot_capacity - 1;
+  const usize first_index = home_index(Trait::hash(key));
+
+  usize index = first_index;
+  do {
+    const u32 el = slots[index];
+    if (el == EMPTY_INDEX) {
+      return nullptr;
+    }
+    else if (el != TOMBSTONE_INDEX && Trait::eq(key, keys[el])) {
+      return slots + index;
+    }
+
+    index = (index + 1) & mask;
+  } while (index != first_index);
+
+  return nullptr;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+u32* DenseHashTable<K, T, Trait>::find_insert_slot(const param_t key) const {
+  ASSERT(!Trait::eq(key, Trait::EMPTY)
+      && !Trait::eq(key, Trait::TOMBSTONE));
+  ASSERT(slot_capacity > 0);
+
+  const usize mask = slot_capacity - 1;
+  const usize first_index = home_index(Trait::hash(key));
+
+  u32* first_tombstone = nullptr;
+
+  usize index = first_index;
+  do {
+    const u32 el = slots[index];
+    if (el == EMPTY_INDEX) {
+      return first_tombstone != nullptr ? first_tombstone : slots + index;
+    }
+    else if (el == TOMBSTONE_INDEX) {
+      if (first_tombstone == nullptr) first_tombstone = slots + index;
+    }
+    else if (Trait::eq(key, keys[el])) {
+      return slots + index;
+    }
+
+    index = (index + 1) & mask;
+  } while (index != first_index);
+
+  ASSERT(first_tombstone != nullptr);
+  return first_tombstone;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+void DenseHashTable<K, T, Trait>::try_extend(usize num) {
+  ASSERT(used + num < static_cast<usize>(TOMBSTONE_INDEX));
+
+  if (used + num > el_capacity) {
+    usize new_capacity = el_capacity == 0 ? 8 : el_capacity;
+    while (used + num > new_capacity) {
+      new_capacity <<= 1;
+    }
+
+    value_t* new_keys = allocate_default<value_t>(new_capacity);
+    T* new_values = allocate_default<T>(new_capacity);
+
+    for (usize i = 0; i < used; ++i) {
+      new_keys[i] = std::move(keys[i]);
+      new_values[i] = std::move(values[i]);
+    }
+
+    free_destruct_n<value_t>(keys, el_capacity);
+    free_destruct_n<T>(values, el_capacity);
+
+    keys = new_keys;
+    values = new_values;
+    el_capacity = new_capacity;
+  }
+
+  if (needs_resize(num)) {
+    AXLE_HASH_RESIZE_TIMER(resize_stats);
+
+    // The rebuild drops every tombstone, which may be enough on its own
+    tombstones = 0;
+    if (slot_capacity == 0) {
+      slot_capacity = 8;
+    }
+    while (needs_resize(num)) {
+      slot_capacity <<= 1;
+    }
+
+    free_no_destruct<u32>(slots);
+    slots = allocate_default<u32>(slot_capacity);
+    for (usize i = 0; i < slot_capacity; ++i) {
+      slots[i] = EMPTY_INDEX;
+    }
+
+    const usize mask = slot_capacity - 1;
+    for (usize i = 0; i < used; ++i) {
+      usize index = home_index(Trait::hash(keys[i]));
+      while (slots[index] != EMPTY_INDEX) {
+        index = (index + 1) & mask;
+      }
+      slots[index] = static_cast<u32>(i);
+    }
+  }
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+bool DenseHashTable<K, T, Trait>::contains(const param_t key) const {
+  return find_slot(key) != nullptr;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+T* DenseHashTable<K, T, Trait>::get_val(const param_t key) const {
+  const u32* slot = find_slot(key);
+  if (slot == nullptr) return nullptr;
+  return values + *slot;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+void DenseHashTable<K, T, Trait>::insert(const param_t key, T&& val) {
+  if (slot_capacity > 0) {
+    u32* slot = find_slot(key);
+    if (slot != nullptr) {
+      values[*slot] = std::move(val);
+      return;
+    }
+  }
+
+  try_extend(1);
+
+  u32* slot = find_insert_slot(key);
+  ASSERT(*slot == EMPTY_INDEX || *slot == TOMBSTONE_INDEX);
+  if (*slot == TOMBSTONE_INDEX) tombstones -= 1;
+
+  *slot = static_cast<u32>(used);
+  keys[used] = key;
+  values[used] = std::move(val);
+  used += 1;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+T* DenseHashTable<K, T, Trait>::get_or_create(const param_t key) {
+  if (slot_capacity > 0) {
+    u32* slot = find_slot(key);
+    if (slot != nullptr) {
+      return values + *slot;
+    }
+  }
+
+  try_extend(1);
+
+  u32* slot = find_insert_slot(key);
+  ASSERT(*slot == EMPTY_INDEX || *slot == TOMBSTONE_INDEX);
+  if (*slot == TOMBSTONE_INDEX) tombstones -= 1;
+
+  *slot = static_cast<u32>(used);
+  keys[used] = key;
+  values[used] = T();
+  used += 1;
+
+  return values + (used - 1);
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+u32 DenseHashTable<K, T, Trait>::take_index(u32* slot) {
+  const u32 index = *slot;
+  *slot = TOMBSTONE_INDEX;
+  tombstones += 1;
+
+  const u32 last = static_cast<u32>(used - 1);
+  if (index != last) {
+    // Repoint the slot of the last entry at the gap it is moved into
+    u32* last_slot = find_slot(keys[last]);
+    ASSERT(last_slot != nullptr && *last_slot == last);
+    *last_slot = index;
+
+    std::swap(keys[index], keys[last]);
+    std::swap(values[index], values[last]);
+  }
+
+  used -= 1;
+  return last;
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+void DenseHashTable<K, T, Trait>::remove(const param_t key) {
+  u32* slot = find_slot(key);
+  if (slot == nullptr) return;
+
+  const u32 last = take_index(slot);
+  keys[last] = Trait::EMPTY;
+  values[last] = T();
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+T DenseHashTable<K, T, Trait>::take(const param_t key) {
+  u32* slot = find_slot(key);
+  ASSERT(slot != nullptr);
+
+  const u32 last = take_index(slot);
+  keys[last] = Trait::EMPTY;
+  return std::exchange(values[last], T());
+}
+
+template<typename K, typename T, ValidInternalTrait Trait>
+HashTableStats DenseHashTable<K, T, Trait>::stats() const {
+  HashTableStats s = {};
+  s.capacity = slot_capacity;
+  s.used = used;
+  s.tombstones = tombstones;
+
+  for (usize i = 0; i < slot_capacity; ++i) {
+    const u32 el = slots[i];
+    if (el == EMPTY_INDEX || el == TOMBSTONE_INDEX) continue;
+
+    s.add_probe(i, home_index(Trait::hash(keys[el])));
+  }
+
+#ifdef AXLE_HASH_STATS
+  s.resize_count = resize_stats.count;
+  s.resize_time_ns = resize_stats.time_ns;
+#endif
+
+  return s;
+}
+
+}
+
+namespace Axle::Format {
+  template<>
+  struct FormatArg<Hash::HashTableStats> {
+    template<Formatter F>
+    static void load_string(F& res, const Hash::HashTableStats& s) {
+      res.load_string_lit("capacity: ");
+      FormatArg<usize>::load_string(res, s.capacity);
+      res.load_string_lit(", used: ");
+      FormatArg<usize>::load_string(res, s.used);
+      res.load_string_lit(" (load ");
+      FormatArg<float>::load_string(res, s.load_factor());
+      res.load_string_lit("), tombstones: ");
+      FormatArg<usize>::load_string(res, s.tombstones);
+      res.load_string_lit(" (");
+      FormatArg<float>::load_string(res, s.tombstone_ratio());
+      res.load_string_lit("), probes: mean ");
+      FormatArg<float>::load_string(res, s.probe_mean());
+      res.load_string_lit(", max ");
+      FormatArg<usize>::load_string(res, s.probe_max);
+      res.load_string_lit(", histogram [");
+      FormatArg<PrintList<usize>>::load_string(res, PrintList<usize>{ view_arr(s.probe_histogram) });
+      res.load_string_lit("], resizes: ");
+      FormatArg<usize>::load_string(res, s.resize_count);
+      res.load_string_lit(" (");
+      FormatArg<u64>::load_string(res, s.resize_time_ns);
+      res.load_string_lit("ns)");
+    }
+  };
 }
 
 #endif
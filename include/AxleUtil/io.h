@@ -2,7 +2,11 @@
 #define AXLEUTIL_IO_H_
 
 #include <AxleUtil/safe_lib.h>
-#include <AxleUtil/formattable.h>
+#include <AxleUtil/format.h>
+#include <AxleUtil/log_level.h>
+#include <AxleUtil/binary_log.h>
+
+#include <cstdio>
 
 namespace Axle {
 namespace IO_Single {
@@ -11,9 +15,10 @@ namespace IO_Single {
   void print(const ViewArr<const char>& string);
   void print(const char c);
 
+  // Literals, so the null terminator is not printed
   template<usize N>
   void print(const char(&string)[N]) {
-    print(string, N);
+    print(string, N - 1);
   }
 
   void err_print(const char* string, usize N);
@@ -23,7 +28,7 @@ namespace IO_Single {
 
   template<usize N>
   void err_print(const char(&string)[N]) {
-    err_print(string, N);
+    err_print(string, N - 1);
   }
 
   void lock();
@@ -45,7 +50,54 @@ namespace IO_Single {
   };
 }
 
+namespace IO {
+  enum struct Stream : u8 {
+    Out, Err,
+  };
+
+  // IO:: and LOG:: output goes into a buffer owned by the calling thread
+  // Only whole lines are written out, each in one write under the io lock, so threads never split each others lines
+  // A buffer is written once it holds enough lines (see set_flush_lines), when it is full, on flush and at thread exit
+  // Buffered stdout is always written before the same thread's stderr or IO_Single output
+  void write(Stream stream, const char* string, usize N);
+  void write(Stream stream, char c);
+
+  // Ends a print, if it stopped part way through a line the buffer is written straight away
+  // so that e.g. "test ...\t" shows up before the test runs
+  void end_print(Stream stream);
+
+  // Writes everything this thread has buffered, even partial lines
+  void flush();
+
+  // Lines a buffer collects before it is written, stdout defaults to 32 and stderr to 1
+  void set_flush_lines(Stream stream, u32 lines);
+
+  // Where this thread's buffer is written, anything already buffered goes to the old file first
+  void set_output(Stream stream, FILE* file);
+}
+
 namespace Format {
+  template<IO::Stream S>
+  struct BufferedPrintFormatter {
+    template<usize N>
+    void load_string_lit(const char(&str)[N]) {
+      IO::write(S, str, N - 1);
+    }
+
+    template<usize N>
+    void load_string_exact(const char(&str)[N]) {
+      IO::write(S, str, N);
+    }
+
+    inline void load_string(const char* str, usize N) {
+      IO::write(S, str, N);
+    }
+
+    inline void load_char(char c) {
+      IO::write(S, c);
+    }
+  };
+
   struct STPrintFormatter {
     template<usize N>
     void load_string_lit(const char(&str)[N]) {
@@ -54,7 +106,7 @@ namespace Format {
 
     template<usize N>
     void load_string_exact(const char(&str)[N]) {
-      IO_Single::print(str);
+      IO_Single::print(str, N);
     }
 
     inline void load_string(const char* str, usize N) {
@@ -75,7 +127,7 @@ namespace Format {
 
     template<usize N>
     void load_string_exact(const char(&str)[N]) {
-      IO_Single::err_print(str);
+      IO_Single::err_print(str, N);
     }
 
     inline void load_string(const char* str, usize N) {
@@ -100,97 +152,157 @@ namespace IO_Single {
 
 namespace IO {
   inline void print(const char* string, usize N) {
-    IO_Single::ScopeLock lock;
-    IO_Single::print(string, N);
+    write(Stream::Out, string, N);
+    end_print(Stream::Out);
   }
   inline void print(const ViewArr<char>& string) {
-    IO_Single::ScopeLock lock;
-    IO_Single::print(string);
+    write(Stream::Out, string.data, string.size);
+    end_print(Stream::Out);
   }
   inline void print(const ViewArr<const char>& string) {
-    IO_Single::ScopeLock lock;
-    IO_Single::print(string);
+    write(Stream::Out, string.data, string.size);
+    end_print(Stream::Out);
   }
   inline void print(const char c) {
-    IO_Single::ScopeLock lock;
-    IO_Single::print(c);
+    write(Stream::Out, c);
+    end_print(Stream::Out);
   }
 
   template<usize N>
   inline void print(const char(&string)[N]) {
-    IO_Single::ScopeLock lock;
-    IO_Single::print(string, N);
+    write(Stream::Out, string, N - 1);
+    end_print(Stream::Out);
   }
 
   inline void err_print(const char* string, usize N) {
-    IO_Single::ScopeLock lock;
-    IO_Single::err_print(string, N);
+    write(Stream::Err, string, N);
+    end_print(Stream::Err);
   }
   inline void err_print(const ViewArr<char>& string) {
-    IO_Single::ScopeLock lock;
-    IO_Single::err_print(string);
+    write(Stream::Err, string.data, string.size);
+    end_print(Stream::Err);
   }
   inline void err_print(const ViewArr<const char>& string) {
-    IO_Single::ScopeLock lock;
-    IO_Single::err_print(string);
+    write(Stream::Err, string.data, string.size);
+    end_print(Stream::Err);
   }
   inline void err_print(const char c) {
-    IO_Single::ScopeLock lock;
-    IO_Single::err_print(c);
+    write(Stream::Err, c);
+    end_print(Stream::Err);
   }
 
   template<usize N>
   inline void err_print(const char(&string)[N]) {
-    IO_Single::ScopeLock lock;
-    IO_Single::err_print(string, N);
+    write(Stream::Err, string, N - 1);
+    end_print(Stream::Err);
   }
 
   template<typename ... T>
   void format(const Format::FormatString<T...>& format, const T& ... ts) {
-    IO_Single::ScopeLock lock;
-    Format::STPrintFormatter result;
+    Format::BufferedPrintFormatter<Stream::Out> result;
 
     Format::format_to(result, format, ts...);
+    end_print(Stream::Out);
   }
 
   template<typename ... T>
   void err_format(const Format::FormatString<T...>& format, const T& ... ts) {
-    IO_Single::ScopeLock lock;
-    Format::STErrPrintFormatter result;
+    Format::BufferedPrintFormatter<Stream::Err> result;
 
     Format::format_to(result, format, ts...);
+    end_print(Stream::Err);
   }
 }
 
 namespace LOG {
+  // Hooks for the async backend, see async_log.h
+  bool is_async();
+
+  struct AsyncSlot {
+    char* data = nullptr;
+    bool dropped = false;
+  };
+
+  // data is nullptr and dropped is false if the record has to be written synchronously,
+  // by then everything the thread logged before it has already been written
+  AsyncSlot async_reserve(usize size);
+  void async_commit();
+
   template<typename ... T>
-  void debug(const Format::FormatString<T...>& format, const T& ... ts) {
-    IO_Single::ScopeLock lock;
-    Format::STErrPrintFormatter result;
+  void write_record(Level level, const Format::FormatString<T...>& format, const T& ... ts) {
+    BinaryLog* binary = binary_log();
+    if (binary != nullptr) {
+      binary->write(level, format, ts...);
+      return;
+    }
+
+    const ViewArr<const char> prefix = level_prefix(level);
+
+    if (is_async()) {
+      const usize size = prefix.size + Format::formatted_size(format, ts...) + 1;
+      const AsyncSlot slot = async_reserve(size);
+      if (slot.dropped) return;
+
+      if (slot.data != nullptr) {
+        Format::ViewFormatter result = ViewArr<char>{ slot.data, size };
+
+        result.load_string(prefix.data, prefix.size);
+        Format::format_to(result, format, ts...);
+        result.load_char('\n');
+        ASSERT(result.view.size == size);
+
+        async_commit();
+        return;
+      }
+    }
+
+    Format::BufferedPrintFormatter<IO::Stream::Err> result;
 
-    result.load_string_lit("DEBUG | ");
+    result.load_string(prefix.data, prefix.size);
     Format::format_to(result, format, ts...);
     result.load_char('\n');
   }
 
+  template<typename ... T>
+  void debug(const Format::FormatString<T...>& format, const T& ... ts) {
+    if constexpr (level_enabled(Level::Debug)) {
+      write_record(Level::Debug, format, ts...);
+    }
+  }
+
+  template<typename ... T>
+  void debug(const Gate& gate, const Format::FormatString<T...>& format, const T& ... ts) {
+    if constexpr (level_enabled(Level::Debug)) {
+      if (gate.enabled()) write_record(Level::Debug, format, ts...);
+    }
+  }
+
   template<typename ... T>
   void warn(const Format::FormatString<T...>& format, const T& ... ts) {
-    IO_Single::ScopeLock lock;
-    Format::STErrPrintFormatter result;
+    if constexpr (level_enabled(Level::Warn)) {
+      write_record(Level::Warn, format, ts...);
+    }
+  }
 
-    result.load_string_lit("WARN  | ");
-    Format::format_to(result, format, ts...);
-    result.load_char('\n');
+  template<typename ... T>
+  void warn(const Gate& gate, const Format::FormatString<T...>& format, const T& ... ts) {
+    if constexpr (level_enabled(Level::Warn)) {
+      if (gate.enabled()) write_record(Level::Warn, format, ts...);
+    }
   }
 
   template<typename ... T>
   void error(const Format::FormatString<T...>& format, const T& ... ts) {
-    IO_Single::ScopeLock lock;
-    Format::STErrPrintFormatter result;
+    if constexpr (level_enabled(Level::Error)) {
+      write_record(Level::Error, format, ts...);
+    }
+  }
 
-    result.load_string_lit("ERROR | ");
-    Format::format_to(result, format, ts...);
-    result.load_char('\n');
+  template<typename ... T>
+  void error(const Gate& gate, const Format::FormatString<T...>& format, const T& ... ts) {
+    if constexpr (level_enabled(Level::Error)) {
+      if (gate.enabled()) write_record(Level::Error, format, ts...);
+    }
   }
 }
 }
@@ -0,0 +1,65 @@
+#ifndef AXLEUTIL_LOG_LEVEL_H_
+#define AXLEUTIL_LOG_LEVEL_H_
+
+#include <AxleUtil/safe_lib.h>
+
+#include <atomic>
+
+// Calls below this level are compiled out, 0 keeps everything and 3 removes all logging
+#ifndef AXLE_LOG_MIN_LEVEL
+#define AXLE_LOG_MIN_LEVEL 0
+#endif
+
+namespace Axle::LOG {
+  enum struct Level : u8 {
+    Debug = 0,
+    Warn = 1,
+    Error = 2,
+  };
+
+  // Written before the message of every text record
+  constexpr ViewArr<const char> level_prefix(Level level) {
+    switch (level) {
+      case Level::Debug: return lit_view_arr("DEBUG | ");
+      case Level::Warn: return lit_view_arr("WARN  | ");
+      case Level::Error: return lit_view_arr("ERROR | ");
+    }
+
+    INVALID_CODE_PATH("Invalid log level");
+  }
+
+  inline constexpr u32 MIN_LEVEL = AXLE_LOG_MIN_LEVEL;
+
+  constexpr bool level_enabled(Level level) {
+    return static_cast<u32>(level) >= MIN_LEVEL;
+  }
+
+  // A runtime switch for one category of logging, checked before any formatting or locking
+  // Pass one as the first argument to LOG::debug/warn/error
+  //   inline LOG::Gate NETWORK_LOG{ lit_view_arr("network") };
+  struct Gate {
+    ViewArr<const char> name;
+    std::atomic<bool> on = true;
+
+    constexpr explicit Gate(const ViewArr<const char>& name_, bool on_ = true) : name(name_), on(on_) {}
+
+    Gate(const Gate&) = delete;
+    Gate& operator=(const Gate&) = delete;
+
+    bool enabled() const {
+      return on.load(std::memory_order_relaxed);
+    }
+
+    void set(bool enabled) {
+      on.store(enabled, std::memory_order_relaxed);
+    }
+  };
+}
+
+// The LOG functions drop disabled levels but their arguments are still evaluated
+// These skip the whole call, arguments included
+#define AXLE_LOG_DEBUG(...) do { if constexpr (::Axle::LOG::level_enabled(::Axle::LOG::Level::Debug)) { ::Axle::LOG::debug(__VA_ARGS__); } } while(0)
+#define AXLE_LOG_WARN(...) do { if constexpr (::Axle::LOG::level_enabled(::Axle::LOG::Level::Warn)) { ::Axle::LOG::warn(__VA_ARGS__); } } while(0)
+#define AXLE_LOG_ERROR(...) do { if constexpr (::Axle::LOG::level_enabled(::Axle::LOG::Level::Error)) { ::Axle::LOG::error(__VA_ARGS__); } } while(0)
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <AxleUtil/safe_lib.h>
 
+#include <bit>
+
 namespace Axle {
  
 constexpr inline u64 MAX_DECIMAL_U64_DIGITS = sizeof("18446744073709551615") - 1;
@@ -139,28 +141,9 @@ constexpr inline uint64_t log_10_floor(uint64_t v) {
     INVALID_CODE_PATH("MATH ERROR! Cannot log of 0");
   }
 
-  //Max uint64_t = 18446744073709551615
-  //Max pow 10   = 10000000000000000000ull
-
-  uint64_t max = 20;
-  uint64_t min = 0;
-
-  while (max > min + 1) {
-    uint64_t mid = min + ((max - min) / 2);
-    uint64_t guess = pow_10(mid);
-
-    if (guess == v) {
-      return mid;
-    }
-    else if (guess < v) {
-      min = mid;
-    }
-    else {
-      max = mid;
-    }
-  }
-
-  return min;
+  // 1233/4096 is just over log10(2), so this guess is either right or one too high
+  const uint64_t guess = (static_cast<uint64_t>(std::bit_width(v)) * 1233) >> 12;
+  return guess - static_cast<uint64_t>(v < pow_10(guess));
 }
 
 //Log 2 optimised for small numbers
@@ -4,6 +4,7 @@
 #include <AxleUtil/safe_lib.h>
 #include <AxleUtil/math.h>
 #include <memory>
+#include <xmmintrin.h>
 
 namespace Axle {
 #ifdef AXLE_COUNT_ALLOC
@@ -304,6 +305,11 @@ void free_no_destruct(Self<T>* ptr) {
   std::free((void*)ptr);
 }
 
+// Hint that ptr will be read soon, pulls its cache line into L1
+inline void prefetch_read(const void* ptr) noexcept {
+  _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+}
+
 //TODO: Anything allocated via this memory will not be destroyed
 struct MemoryPool {
   u8* mem = nullptr;
@@ -23,21 +23,30 @@ namespace Axle::Windows::FILES {
 
   using Axle::FILES::ErrorCode;
   using Axle::FILES::OPEN_MODE;
+  using Axle::FILES::MAP_MODE;
+  using Axle::FILES::BufferOptions;
 
   ErrorCode open(FileData*& data,
                  const NativePath& name,
-                 OPEN_MODE open_mode);
+                 OPEN_MODE open_mode,
+                 const BufferOptions& buffer_options);
   ErrorCode create(FileData*& data,
                    const NativePath& name,
-                   OPEN_MODE open_mode);
+                   OPEN_MODE open_mode,
+                   const BufferOptions& buffer_options);
   ErrorCode replace(FileData*& data,
                     const NativePath& name,
-                    OPEN_MODE open_mode);
+                    OPEN_MODE open_mode,
+                    const BufferOptions& buffer_options);
 
   ErrorCode create_empty_directory(const NativePath& name);
 
   OwnedArr<u8> read_full_file(const NativePath& file_name);
 
+  ErrorCode map_file(Axle::FILES::MappedFile& mapped,
+                     const NativePath& file_name,
+                     MAP_MODE map_mode);
+
   bool exists(const NativePath& name);
 
   constexpr bool is_absolute_path(const ViewArr<const char>& r) {
@@ -0,0 +1,132 @@
+#ifndef AXLEUTIL_PARSE_H_
+#define AXLEUTIL_PARSE_H_
+
+#include <AxleUtil/safe_lib.h>
+
+#include <limits>
+
+namespace Axle {
+  namespace ParseInternal {
+    // Little endian load so byte 0 is the first character
+    constexpr u64 load_eight(const char* str) {
+      u64 v = 0;
+      for (usize i = 0; i < 8; ++i) {
+        v |= static_cast<u64>(static_cast<u8>(str[i])) << (i * 8);
+      }
+      return v;
+    }
+
+    constexpr bool is_eight_digits(u64 v) {
+      // High nibbles must all be 3 and adding 6 to the low ones must not carry
+      return ((v & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull)
+          && (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull);
+    }
+
+    // Combines pairs, then pairs of pairs, then the two halves
+    constexpr u32 parse_eight_digits(u64 v) {
+      v -= 0x3030303030303030ull;
+      v = (v * 10) + (v >> 8);
+      v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32)))
+           + (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+      return static_cast<u32>(v);
+    }
+
+    constexpr u32 digit_value(char c) {
+      if (c >= '0' && c <= '9') return static_cast<u32>(c - '0');
+      if (c >= 'a' && c <= 'f') return static_cast<u32>(c - 'a' + 10);
+      if (c >= 'A' && c <= 'F') return static_cast<u32>(c - 'A' + 10);
+      return 0xFF;
+    }
+
+    constexpr bool parse_decimal(const char* str, usize len, u64& out) {
+      u64 v = 0;
+      usize i = 0;
+
+      // Up to 19 digits always fit, so only the last one needs checking for overflow
+      while (len - i >= 8 && i + 8 <= 19) {
+        const u64 chunk = load_eight(str + i);
+        if (!is_eight_digits(chunk)) return false;
+        v = v * 100000000ull + parse_eight_digits(chunk);
+        i += 8;
+      }
+
+      for (; i < len; ++i) {
+        const char c = str[i];
+        if (c < '0' || c > '9') return false;
+        const u64 d = static_cast<u64>(c - '0');
+
+        if (i >= 19 && v > (std::numeric_limits<u64>::max() - d) / 10) return false;
+        v = v * 10 + d;
+      }
+
+      out = v;
+      return true;
+    }
+
+    constexpr bool parse_power_of_2(const char* str, usize len, u32 bits, u64& out) {
+      u64 v = 0;
+      const u32 base = 1u << bits;
+      for (usize i = 0; i < len; ++i) {
+        const u32 d = digit_value(str[i]);
+        if (d >= base) return false;
+        if ((v >> (64 - bits)) != 0) return false;
+        v = (v << bits) | d;
+      }
+
+      out = v;
+      return true;
+    }
+
+    // Magnitude of an integer with an optional 0x or 0b prefix
+    constexpr bool parse_magnitude(const ViewArr<const char>& str, u64 max, u64& out) {
+      if (str.size == 0) return false;
+
+      u64 v = 0;
+      if (str.size > 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        if (!parse_power_of_2(str.data + 2, str.size - 2, 4, v)) return false;
+      }
+      else if (str.size > 2 && str[0] == '0' && (str[1] == 'b' || str[1] == 'B')) {
+        if (!parse_power_of_2(str.data + 2, str.size - 2, 1, v)) return false;
+      }
+      else if (!parse_decimal(str.data, str.size, v)) {
+        return false;
+      }
+
+      if (v > max) return false;
+      out = v;
+      return true;
+    }
+  }
+
+  // Parses the whole string as a number, returns false if anything is left over or it does not fit
+  // Integers may be written in hex (0x) or binary (0b), signed ones after an optional '-'
+  // out is left unchanged on failure
+  template<typename T>
+    requires(std::is_integral_v<T> && !OneOf<T, bool, char>)
+  constexpr bool parse_number(const ViewArr<const char>& str, T& out) {
+    if constexpr (std::is_unsigned_v<T>) {
+      u64 v = 0;
+      if (!ParseInternal::parse_magnitude(str, std::numeric_limits<T>::max(), v)) return false;
+      out = static_cast<T>(v);
+      return true;
+    }
+    else {
+      using U = std::make_unsigned_t<T>;
+      const bool negative = str.size > 0 && str[0] == '-';
+      const ViewArr<const char> digits = negative ? view_arr(str, 1, str.size - 1) : str;
+
+      // The negative range is one larger
+      const u64 max = static_cast<u64>(std::numeric_limits<T>::max()) + (negative ? 1u : 0u);
+
+      u64 v = 0;
+      if (!ParseInternal::parse_magnitude(digits, max, v)) return false;
+      out = static_cast<T>(negative ? static_cast<U>(0u - v) : static_cast<U>(v));
+      return true;
+    }
+  }
+
+  bool parse_number(const ViewArr<const char>& str, float& out);
+  bool parse_number(const ViewArr<const char>& str, double& out);
+}
+
+#endif
@@ -6,6 +6,9 @@
 
 #include <AxleUtil/primitives.h>
 #include <AxleUtil/panic.h>
+#include <AxleUtil/simd.h>
+
+#include <type_traits>
 
 namespace Axle {
 #define BYTE(a) (static_cast<uint8_t>(a))
@@ -31,10 +34,23 @@ constexpr inline void memcpy_ts(T* dest, size_t dest_size, const T* source, size
   }
 }
 
+// Types that can be compared with the byte kernels
+template<typename T>
+concept SimdByte = sizeof(T) == 1 && std::is_integral_v<T>;
+
+// Shorter than this a plain inline loop beats calling through the kernel table
+inline constexpr usize SIMD_DISPATCH_MIN = 16;
+
 template<typename T>
 constexpr inline bool memeq_ts(const T* buff1, const T* buff2, size_t length) {
   if (buff1 == buff2) return true;
 
+  if constexpr (SimdByte<T>) {
+    if (!std::is_constant_evaluated() && length >= SIMD_DISPATCH_MIN) {
+      return SIMD::memeq(reinterpret_cast<const u8*>(buff1), reinterpret_cast<const u8*>(buff2), length);
+    }
+  }
+
   for (size_t i = 0; i < length; ++i) {
     if (buff1[i] != buff2[i]) return false;
   }
@@ -43,17 +59,25 @@ constexpr inline bool memeq_ts(const T* buff1, const T* buff2, size_t length) {
 }
 
 constexpr bool streq_ts(const char* str1, const char* str2) {
-  while (str1[0] != '\0' && str1[0] == str2[0]) {
-    str1++;
-    str2++;
+  usize i = 0;
+  while (str1[i] != '\0' && str1[i] == str2[i]) {
+    i++;
+    if (!std::is_constant_evaluated() && i == SIMD_DISPATCH_MIN) {
+      return SIMD::streq(str1 + i, str2 + i);
+    }
   }
 
-  return str1[0] == str2[0];//both are ended
+  return str1[i] == str2[i];//both are ended
 }
 
 constexpr usize strlen_ts(const char* c) {
   usize counter = 0;
-  while (*c != '\0') { c++; counter++; }
+  while (c[counter] != '\0') {
+    counter++;
+    if (!std::is_constant_evaluated() && counter == SIMD_DISPATCH_MIN) {
+      return counter + SIMD::strlen(c + counter);
+    }
+  }
 
   return counter;
 }
@@ -188,14 +212,7 @@ constexpr inline void memcpy_ts(const ViewArr<T>& dest, const ViewArr<T>& src) {
 template<typename T>
 [[nodiscard]] constexpr inline bool memeq_ts(const ViewArr<const T>& dest, const ViewArr<const T>& src) {
   if (dest.size != src.size) return false;
-  if (dest.data == src.data) return true;
-
-  const size_t length = dest.size;
-  for (size_t i = 0; i < length; ++i) {
-    if (dest.data[i] != src.data[i]) return false;
-  }
-
-  return true;
+  return memeq_ts<T>(dest.data, src.data, dest.size);
 }
 
 template<typename T>
@@ -213,6 +230,51 @@ template<typename T>
   return memeq_ts<T>(ViewArr<const T>(dest), src);
 }
 
+// Search functions return nullptr when there is no match
+
+[[nodiscard]] constexpr const char* find_byte(const ViewArr<const char>& str, char c) {
+  if (!std::is_constant_evaluated()) {
+    return reinterpret_cast<const char*>(
+      SIMD::find_byte(reinterpret_cast<const u8*>(str.data), str.size, static_cast<u8>(c)));
+  }
+
+  for (usize i = 0; i < str.size; ++i) {
+    if (str.data[i] == c) return str.data + i;
+  }
+  return nullptr;
+}
+
+[[nodiscard]] constexpr const char* find_any_of(const ViewArr<const char>& str, const ViewArr<const char>& set) {
+  if (!std::is_constant_evaluated()) {
+    return reinterpret_cast<const char*>(
+      SIMD::find_any_of(reinterpret_cast<const u8*>(str.data), str.size,
+                        reinterpret_cast<const u8*>(set.data), set.size));
+  }
+
+  for (usize i = 0; i < str.size; ++i) {
+    for (usize j = 0; j < set.size; ++j) {
+      if (str.data[i] == set.data[j]) return str.data + i;
+    }
+  }
+  return nullptr;
+}
+
+// An empty sub matches at the start
+[[nodiscard]] constexpr const char* find_substring(const ViewArr<const char>& str, const ViewArr<const char>& sub) {
+  if (!std::is_constant_evaluated()) {
+    return reinterpret_cast<const char*>(
+      SIMD::find_substring(reinterpret_cast<const u8*>(str.data), str.size,
+                           reinterpret_cast<const u8*>(sub.data), sub.size));
+  }
+
+  if (sub.size > str.size) return nullptr;
+
+  for (usize i = 0; i <= str.size - sub.size; ++i) {
+    if (memeq_ts<char>(str.data + i, sub.data, sub.size)) return str.data + i;
+  }
+  return nullptr;
+}
+
 template<typename T>
 struct Viewable {
   static_assert(DependentFalse<T>::VAL, "Attempted to use unspecialized viewable");
@@ -0,0 +1,35 @@
+#ifndef AXLEUTIL_SIMD_H_
+#define AXLEUTIL_SIMD_H_
+
+#include <AxleUtil/primitives.h>
+
+// Vectorised byte kernels behind the runtime versions of memeq_ts, strlen_ts etc
+// Picks the widest instruction set the cpu supports the first time any kernel is called
+// Use the safe_lib wrappers instead, they fall back to scalar loops in constant evaluation
+namespace Axle::SIMD {
+  enum struct Level : u8 {
+    Scalar, SSE2, AVX2,
+  };
+
+  // Highest level supported by this cpu
+  Level detected_level() noexcept;
+  Level active_level() noexcept;
+
+  // Clamped to detected_level, mostly useful for testing every path
+  void set_level(Level level) noexcept;
+
+  bool memeq(const u8* a, const u8* b, usize len) noexcept;
+
+  // Index of the first differing byte, or len if there are none
+  usize mismatch(const u8* a, const u8* b, usize len) noexcept;
+
+  usize strlen(const char* str) noexcept;
+  bool streq(const char* a, const char* b) noexcept;
+
+  // All return nullptr when nothing is found
+  const u8* find_byte(const u8* data, usize len, u8 byte) noexcept;
+  const u8* find_any_of(const u8* data, usize len, const u8* set, usize set_len) noexcept;
+  const u8* find_substring(const u8* data, usize len, const u8* sub, usize sub_len) noexcept;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef AXLEUTIL_SPLIT_H_
+#define AXLEUTIL_SPLIT_H_
+
+#include <AxleUtil/utility.h>
+
+// Splitters that hand out views into the source buffer instead of copying
+// Searching is done with the SIMD find_byte/find_any_of from safe_lib
+namespace Axle {
+  // Splits on '\n', a '\r' before it is dropped so "\r\n" also works
+  // A final line ending does not start a new empty line
+  struct LineSplitter {
+    ViewArr<const char> rest = {};
+
+    constexpr LineSplitter() = default;
+    constexpr LineSplitter(const ViewArr<const char>& data) : rest(data) {}
+
+    bool next(ViewArr<const char>& line);
+  };
+
+  // Splits on any of the delimiters
+  // With a quote character, a field starting with it runs until the matching quote
+  // and can contain delimiters and line endings. The quotes are not part of the field,
+  // doubled quotes inside it are left as they are (nothing is copied to remove them)
+  // To split whole files with quoted line endings, include '\n' in the delimiters and
+  // use end_of_record instead of a LineSplitter. A '\r' before the '\n' is dropped and
+  // a final '\n' does not start a new empty record
+  struct FieldSplitter {
+    ViewArr<const char> rest = {};
+    ViewArr<const char> delimiters = {};
+    char quote = '\0';
+    bool finished = false;
+
+    // Set by next, true if the last field was quoted
+    bool last_quoted = false;
+    // Set by next, the delimiter that ended the last field or '\0' at the end of the data
+    char last_delimiter = '\0';
+
+    constexpr bool end_of_record() const {
+      return last_delimiter == '\n' || last_delimiter == '\0';
+    }
+
+    constexpr FieldSplitter() = default;
+    constexpr FieldSplitter(const ViewArr<const char>& data, const ViewArr<const char>& delims, char quote_ = '\0')
+      : rest(data), delimiters(delims), quote(quote_), finished(data.size == 0) {}
+
+    bool next(ViewArr<const char>& field);
+  };
+
+  // LineSplitter for data that arrives in chunks
+  // Lines inside a chunk are still views into it, only a line crossing
+  // the end of a chunk is copied into carry
+  // A returned line is valid until the next call to next or finish
+  struct LineStream {
+    ViewArr<const char> chunk = {};
+    Array<char> carry = {};
+    bool carry_returned = false;
+
+    // The previous chunk must have been used up (next returned false)
+    // chunk must stay valid until then
+    void push(const ViewArr<const char>& data);
+
+    // false once the chunk has no more complete lines
+    bool next(ViewArr<const char>& line);
+
+    // Returns the last line if the data did not end with a line ending
+    bool finish(ViewArr<const char>& line);
+  };
+}
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef AXLEUTIL_STATIC_HASH_H_
+#define AXLEUTIL_STATIC_HASH_H_
+
+#include <AxleUtil/safe_lib.h>
+#include <AxleUtil/math.h>
+#include <AxleUtil/utility.h>
+
+namespace Axle::Hash {
+template<typename T>
+concept ValidStaticTrait = requires {
+  typename T::value_t;
+  requires requires (const typename T::value_t& k) {
+    { T::hash(k) } -> Axle::IS_SAME_TYPE<u64>;
+    { T::eq(k, k) } -> Axle::IS_SAME_TYPE<bool>;
+  };
+};
+
+template<typename T>
+struct DefaultStaticHashTrait;
+
+template<>
+struct DefaultStaticHashTrait<ViewArr<const char>> {
+  using value_t = ViewArr<const char>;
+
+  static constexpr u64 hash(const value_t& s) noexcept {
+    return fnv1a_hash(s.data, s.size);
+  }
+
+  static constexpr bool eq(const value_t& s0, const value_t& s1) noexcept {
+    return memeq_ts<char>(s0, s1);
+  }
+};
+
+template<typename T>
+  requires(std::is_integral_v<T> || std::is_enum_v<T>)
+struct DefaultStaticHashTrait<T> {
+  using value_t = T;
+
+  static constexpr u64 hash(const value_t& t) noexcept {
+    return fnv1a_hash_u64(FNV1_HASH_BASE, static_cast<u64>(t));
+  }
+
+  static constexpr bool eq(const value_t& t0, const value_t& t1) noexcept {
+    return t0 == t1;
+  }
+};
+
+template<typename K, typename V>
+struct StaticHashEntry {
+  K key;
+  V val;
+};
+
+// Immutable perfect hash map built entirely at compile time
+// Hash and displace: each key's hash picks a bucket, and each bucket stores
+// the seed that sends all of its keys to distinct slots
+// Lookup is always one hash, one seed load and one key comparison
+template<typename K, typename V, usize N, ValidStaticTrait Trait = DefaultStaticHashTrait<K>>
+struct StaticHashMap {
+  static_assert(N > 0, "Static hash map must contain at least one key");
+  static_assert(N < static_cast<usize>(0xFFFFFFFFu), "Static hash map is indexed with u32");
+
+  constexpr static usize NUM_SLOTS = ceil_to_pow_2(N);
+  constexpr static usize SLOT_BITS = small_log_2_floor(NUM_SLOTS);
+  constexpr static usize NUM_BUCKETS = (N / 2) + 1;
+  constexpr static u32 EMPTY_SLOT = static_cast<u32>(-1);
+
+  ConstArray<u32, NUM_BUCKETS> seeds = {};
+  ConstArray<u32, NUM_SLOTS> slots = {};
+  ConstArray<K, N> keys = {};
+  ConstArray<V, N> values = {};
+
+  constexpr static usize bucket_of(u64 hash) noexcept {
+    return static_cast<usize>(hash % NUM_BUCKETS);
+  }
+
+  constexpr static usize slot_of(u64 hash, u32 seed) noexcept {
+    if constexpr (SLOT_BITS == 0) {
+      return 0;
+    }
+    else {
+      // Top bits of the multiply depend on every bit of the hash
+      return static_cast<usize>(fnv1a_hash_u32(hash, seed) >> (64 - SLOT_BITS));
+    }
+  }
+
+  constexpr usize size() const noexcept { return N; }
+
+  constexpr u32 index_of(const typename Trait::value_t& key) const {
+    const u64 hash = Trait::hash(key);
+    const u32 index = slots[slot_of(hash, seeds[bucket_of(hash)])];
+
+    if (index == EMPTY_SLOT || !Trait::eq(keys[index], key)) {
+      return EMPTY_SLOT;
+    }
+    return index;
+  }
+
+  constexpr bool contains(const typename Trait::value_t& key) const {
+    return index_of(key) != EMPTY_SLOT;
+  }
+
+  constexpr const V* get_val(const typename Trait::value_t& key) const {
+    const u32 index = index_of(key);
+    if (index == EMPTY_SLOT) return nullptr;
+    return &values[index];
+  }
+};
+
+// Fails to compile if two keys are equal
+template<typename K, typename V, ValidStaticTrait Trait = DefaultStaticHashTrait<K>, usize N>
+consteval StaticHashMap<K, V, N, Trait> make_static_hash_map(const StaticHashEntry<K, V> (&entries)[N]) {
+  using Map = StaticHashMap<K, V, N, Trait>;
+  constexpr u32 MAX_SEED = 1u << 16;
+
+  Map map = {};
+
+  ConstArray<u64, N> hashes = {};
+  ConstArray<u32, Map::NUM_BUCKETS> bucket_sizes = {};
+
+  for (usize i = 0; i < N; ++i) {
+    for (usize j = 0; j < i; ++j) {
+      if (Trait::eq(entries[i].key, entries[j].key)) {
+        INVALID_CODE_PATH("Duplicate key in static hash map");
+      }
+    }
+
+    hashes[i] = Trait::hash(entries[i].key);
+    bucket_sizes[Map::bucket_of(hashes[i])] += 1;
+
+    map.keys[i] = entries[i].key;
+    map.values[i] = entries[i].val;
+  }
+
+  // Place the largest buckets first while there are the most free slots
+  ConstArray<u32, Map::NUM_BUCKETS> order = {};
+  for (usize b = 0; b < Map::NUM_BUCKETS; ++b) {
+    usize i = b;
+    while (i > 0 && bucket_sizes[order[i - 1]] < bucket_sizes[b]) {
+      order[i] = order[i - 1];
+      i -= 1;
+    }
+    order[i] = static_cast<u32>(b);
+  }
+
+  for (usize s = 0; s < Map::NUM_SLOTS; ++s) {
+    map.slots[s] = Map::EMPTY_SLOT;
+  }
+
+  ConstArray<u32, N> members = {};
+  ConstArray<usize, N> member_slots = {};
+
+  for (const u32 b : order) {
+    const usize bucket_size = bucket_sizes[b];
+    if (bucket_size == 0) break;
+
+    usize count = 0;
+    for (usize i = 0; i < N; ++i) {
+      if (Map::bucket_of(hashes[i]) == b) {
+        members[count] = static_cast<u32>(i);
+        count += 1;
+      }
+    }
+    ASSERT(count == bucket_size);
+
+    u32 seed = 0;
+    while (true) {
+      if (seed == MAX_SEED) {
+        INVALID_CODE_PATH("Could not find a perfect hash for static hash map");
+      }
+
+      bool placed = true;
+      for (usize m = 0; m < count && placed; ++m) {
+        const usize slot = Map::slot_of(hashes[members[m]], seed);
+        placed = map.slots[slot] == Map::EMPTY_SLOT;
+
+        for (usize prev = 0; prev < m && placed; ++prev) {
+          placed = member_slots[prev] != slot;
+        }
+
+        member_slots[m] = slot;
+      }
+
+      if (placed) break;
+      seed += 1;
+    }
+
+    map.seeds[b] = seed;
+    for (usize m = 0; m < count; ++m) {
+      map.slots[member_slots[m]] = members[m];
+    }
+  }
+
+  return map;
+}
+}
+
+#endif
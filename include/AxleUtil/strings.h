@@ -3,7 +3,10 @@
 
 #include <AxleUtil/hash.h>
 #include <AxleUtil/format.h>
+#include <AxleUtil/files_base.h>
+#include <AxleUtil/threading.h>
 
+#include <atomic>
 #include <compare>
 
 namespace Axle {
@@ -76,6 +79,13 @@ constexpr std::strong_ordering lexicographic_order(const ViewArr<const char>& l,
   const char* const lstr = l.data;
   const char* const rstr = r.data;
 
+  if (!std::is_constant_evaluated()) {
+    const usize i = SIMD::mismatch(reinterpret_cast<const u8*>(lstr), reinterpret_cast<const u8*>(rstr), min_size);
+    if (i == min_size) return size_order;
+
+    return lstr[i] <=> rstr[i];
+  }
+
   for (usize i = 0; i < min_size; i++) {
     const char cl = lstr[i];
     const char cr = rstr[i];
@@ -96,27 +106,74 @@ constexpr std::strong_ordering lexicographic_order(const InternString* l, const
 struct Table {
   constexpr static float LOAD_FACTOR = 0.75;
 
-  const InternString** data = nullptr;
+  // The top of the hash and the length are kept inline so most probes
+  // can be rejected without loading the string itself
+  struct Slot {
+    const InternString* string = nullptr;
+    u32 hash_fragment = 0;
+    u32 len_fragment = 0;
+  };
+
+  Slot* data = nullptr;
   size_t num_full = 0;
-  size_t size = 0;
+  size_t size = 0;// always a power of 2
+
+#ifdef AXLE_HASH_STATS
+  Hash::ResizeStats resize_stats = {};
+  Hash::LiveTableRegistration<Table> live_registration{ this };
+#endif
 
   Table();
   ~Table();
 
+  // Low bits of the hash are the index, so take the fragment from the top
+  static constexpr u32 hash_fragment(uint64_t hash) noexcept {
+    return static_cast<u32>(hash >> 32);
+  }
+
+  static constexpr Slot make_slot(const InternString* str) noexcept {
+    return { str, hash_fragment(str->hash), static_cast<u32>(str->len) };
+  }
+
+  Hash::HashTableStats stats() const;
+
   void try_resize();
 
-  const InternString** find(const char* str, size_t len, uint64_t hash) const;
-  const InternString** find_empty(uint64_t hash) const;
+  // Grows now so that extra more inserts will not trigger a resize
+  void reserve(usize extra);
+
+  // Drops every entry and goes back to the starting size
+  void clear();
+
+  Slot* find(const char* str, size_t len, uint64_t hash) const;
+  Slot* find_empty(uint64_t hash) const;
+
+  inline void prefetch(uint64_t hash) const {
+    prefetch_read(data + (hash & (size - 1)));
+  }
 };
 
+// Can be a child generation of another interner
+// Lookups check the parents first and only strings missing from all of them are added here,
+// so the child can be dropped (or reset) without touching the parents
+// A parent is read only while it has children, so every string still has exactly one InternString
 struct StringInterner {
   constexpr static usize ALLOC_BLOCK_SIZE = 2048;
   GrowingMemoryPool<ALLOC_BLOCK_SIZE> allocs = {};
   Table table = {};
   InternString empty_string = {};
 
+  // Strings loaded from a snapshot live in here instead of allocs
+  FILES::MappedFile snapshot = {};
+
+  // Must outlive this interner
+  const StringInterner* parent = nullptr;
+  // Number of live interners with this as their parent
+  mutable std::atomic<u32> children = 0;
+
   StringInterner() = default;
-  ~StringInterner() = default;
+  explicit StringInterner(const StringInterner* parent_);
+  ~StringInterner();
 
   // Cannot copy or move
   StringInterner(const StringInterner&) = delete;
@@ -127,6 +184,12 @@ struct StringInterner {
   const InternString* find(const char* string, size_t len) const;
   const InternString* intern(const char* string, size_t len);
 
+  // Only looks in the parent generations, hash is the fnv1a_hash of string
+  const InternString* find_in_parents(const char* string, size_t len, uint64_t hash) const;
+
+  // Every generation shares the empty string of the root
+  const InternString* shared_empty_string() const;
+
   inline const InternString* find(const ViewArr<const char>& arr) const {
     return find(arr.data, arr.size);
   }
@@ -143,6 +206,23 @@ struct StringInterner {
     return intern(arr.data, arr.size);
   }
 
+  // Frees every string owned by this generation, anything from the parents is still valid
+  void reset();
+
+  // Writes every string and the table layout to one file
+  FILES::ErrorCode save_snapshot(const ViewArr<const char>& file_name) const;
+
+  // Maps a file written by save_snapshot, interner must be empty
+  // Strings point straight into the mapping and are not rehashed
+  FILES::ErrorCode load_snapshot(const ViewArr<const char>& file_name);
+
+  // out[i] = find(strings[i]), but with the table slots prefetched ahead of probing
+  void find_batch(const ViewArr<const ViewArr<const char>>& strings, const ViewArr<const InternString*>& out) const;
+
+  // out[i] = intern(strings[i]), but the table is grown at most once
+  // and all the new strings are placed in one allocation
+  void intern_batch(const ViewArr<const ViewArr<const char>>& strings, const ViewArr<const InternString*>& out);
+
   template<typename ... T>
   inline const InternString* format_intern(const Format::FormatString<T...>& fmt, const T& ... ts) {
     Format::ArrayFormatter formatter = {};
@@ -153,6 +233,135 @@ struct StringInterner {
   }
 };
 
+// 4 byte handle to a string in a CompactStringInterner
+// Only meaningful alongside the interner that created it
+struct InternId {
+  u32 id = 0;
+
+  constexpr bool operator==(const InternId&) const = default;
+};
+
+namespace Intern {
+  inline constexpr InternId INVALID_ID = { 0xFFFFFFFF };
+  inline constexpr InternId TOMBSTONE_ID = { 0xFFFFFFFE };
+}
+
+namespace Format {
+  template<>
+  struct FormatArg<InternId> {
+    template<Formatter F>
+    constexpr static void load_string(F& res, InternId id) {
+      res.load_string_lit("InternId(");
+      FormatArg<u32>::load_string(res, id.id);
+      res.load_char(')');
+    }
+  };
+}
+
+// Smaller alternative to StringInterner where strings are named by InternId
+// String bytes are packed into one arena, and id indexes a side table of offset, length and hash
+// Costs 16 bytes plus the string per entry, instead of a separate InternString and pointer
+struct CompactStringInterner {
+  constexpr static float LOAD_FACTOR = 0.75;
+  constexpr static u32 EMPTY_SLOT = Intern::INVALID_ID.id;
+
+  struct Entry {
+    u32 offset = 0;
+    u32 len = 0;
+    u64 hash = 0;
+  };
+
+  Array<char> bytes = {};
+  Array<Entry> entries = {};
+
+  // Index into entries, always a power of 2 in size
+  u32* slots = nullptr;
+  usize slot_count = 0;
+
+  CompactStringInterner() = default;
+  ~CompactStringInterner();
+
+  // Cannot copy or move
+  CompactStringInterner(const CompactStringInterner&) = delete;
+  CompactStringInterner(CompactStringInterner&&) = delete;
+  CompactStringInterner& operator=(const CompactStringInterner&) = delete;
+  CompactStringInterner& operator=(CompactStringInterner&&) = delete;
+
+  // Returns Intern::INVALID_ID if not found
+  InternId find(const ViewArr<const char>& str) const;
+  InternId intern(const ViewArr<const char>& str);
+
+  constexpr usize size() const noexcept {
+    return entries.size;
+  }
+
+  // Unlike StringInterner the bytes move when the arena grows, so this is only valid until the next intern
+  // Hold on to the id instead
+  ViewArr<const char> view(InternId id) const {
+    const Entry& e = entries[id.id];
+    return { bytes.data + e.offset, e.len };
+  }
+
+  u64 hash_of(InternId id) const {
+    return entries[id.id].hash;
+  }
+
+  Hash::HashTableStats stats() const;
+};
+
+// Interner that can be shared between threads
+// Strings are split into shards by the top bits of their hash
+// Finding an already interned string never takes a lock: entries are published with release stores
+// and tables are never freed while the interner is alive, so readers can always finish a probe
+// Inserting only locks the string's shard, which also owns the memory for its strings
+struct ConcurrentStringInterner {
+  constexpr static usize ALLOC_BLOCK_SIZE = 2048;
+  constexpr static usize SHARD_BITS = 6;
+  constexpr static usize NUM_SHARDS = 1 << SHARD_BITS;
+
+  struct ShardTable {
+    std::atomic<const InternString*>* data = nullptr;
+    usize size = 0;
+    ShardTable* retired = nullptr;
+  };
+
+  struct alignas(64) Shard {
+    std::atomic<ShardTable*> table = nullptr;
+    Mutex mutex = {};
+    usize num_full = 0;
+    GrowingMemoryPool<ALLOC_BLOCK_SIZE> allocs = {};
+  };
+
+  Shard shards[NUM_SHARDS] = {};
+  InternString empty_string = {};
+
+  ConcurrentStringInterner() = default;
+  ~ConcurrentStringInterner();
+
+  // Cannot copy or move
+  ConcurrentStringInterner(const ConcurrentStringInterner&) = delete;
+  ConcurrentStringInterner(ConcurrentStringInterner&&) = delete;
+  ConcurrentStringInterner& operator=(const ConcurrentStringInterner&) = delete;
+  ConcurrentStringInterner& operator=(ConcurrentStringInterner&&) = delete;
+
+  static constexpr usize shard_index(uint64_t hash) noexcept {
+    return static_cast<usize>(hash >> (64 - SHARD_BITS));
+  }
+
+  const InternString* find(const char* string, size_t len) const;
+  const InternString* intern(const char* string, size_t len);
+
+  inline const InternString* find(const ViewArr<const char>& arr) const {
+    return find(arr.data, arr.size);
+  }
+
+  inline const InternString* intern(const ViewArr<const char>& arr) {
+    return intern(arr.data, arr.size);
+  }
+
+  Hash::HashTableStats stats() const;
+};
+
 namespace Hash {
   template<>
   struct DefaultHashmapTrait<const InternString*> {
@@ -171,10 +380,34 @@ namespace Hash {
   };
 }
 
+namespace Hash {
+  template<>
+  struct DefaultHashmapTrait<InternId> {
+    using value_t = InternId;
+    using param_t = InternId;
+
+    static constexpr const value_t EMPTY = Intern::INVALID_ID;
+    static constexpr const value_t TOMBSTONE = Intern::TOMBSTONE_ID;
+
+    // Ids are dense so they need mixing before use as a hash
+    static constexpr u64 hash(param_t s) noexcept {
+      return fnv1a_hash_u32(FNV1_HASH_BASE, s.id);
+    }
+    static constexpr bool eq(param_t s0, param_t s1) noexcept {
+      return s0 == s1;
+    }
+  };
+}
+
 using InternStringSet = Hash::InternalHashSet<const InternString*>;
 
 template<typename T>
 using InternHashTable = Hash::InternalHashTable<const InternString*, T>;
+
+using InternIdSet = Hash::InternalHashSet<InternId>;
+
+template<typename T>
+using InternIdHashTable = Hash::InternalHashTable<InternId, T>;
 }
 #endif
 
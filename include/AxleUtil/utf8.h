@@ -0,0 +1,137 @@
+#ifndef AXLEUTIL_UTF8_H_
+#define AXLEUTIL_UTF8_H_
+
+#include <AxleUtil/utility.h>
+
+#include <type_traits>
+
+namespace Axle {
+  inline constexpr u32 UNICODE_REPLACEMENT_CHARACTER = 0xFFFD;
+  inline constexpr u32 UNICODE_MAX = 0x10FFFF;
+
+  struct UTF8Decode {
+    u32 code_point = 0;
+    u32 length = 0;// 0 if the bytes are not valid utf-8
+  };
+
+  // Decodes one code point from the start of data, len must be > 0
+  // Strict: rejects overlong forms, surrogates and anything above U+10FFFF
+  constexpr UTF8Decode utf8_decode(const char* data, usize len) noexcept {
+    const auto byte = [data](usize i) { return static_cast<u8>(data[i]); };
+    const auto is_cont = [](u8 b) { return (b & 0xC0) == 0x80; };
+
+    const u8 b0 = byte(0);
+    if (b0 < 0x80) return { b0, 1 };
+
+    if (b0 >= 0xC2 && b0 <= 0xDF) {
+      if (len < 2 || !is_cont(byte(1))) return {};
+      return { (static_cast<u32>(b0 & 0x1F) << 6) | (byte(1) & 0x3F), 2 };
+    }
+
+    if (b0 >= 0xE0 && b0 <= 0xEF) {
+      if (len < 3) return {};
+      const u8 b1 = byte(1);
+      const u8 lo = b0 == 0xE0 ? 0xA0 : 0x80;
+      const u8 hi = b0 == 0xED ? 0x9F : 0xBF;
+      if (b1 < lo || b1 > hi || !is_cont(byte(2))) return {};
+      return { (static_cast<u32>(b0 & 0x0F) << 12) | (static_cast<u32>(b1 & 0x3F) << 6) | (byte(2) & 0x3F), 3 };
+    }
+
+    if (b0 >= 0xF0 && b0 <= 0xF4) {
+      if (len < 4) return {};
+      const u8 b1 = byte(1);
+      const u8 lo = b0 == 0xF0 ? 0x90 : 0x80;
+      const u8 hi = b0 == 0xF4 ? 0x8F : 0xBF;
+      if (b1 < lo || b1 > hi || !is_cont(byte(2)) || !is_cont(byte(3))) return {};
+      return { (static_cast<u32>(b0 & 0x07) << 18) | (static_cast<u32>(b1 & 0x3F) << 12)
+                 | (static_cast<u32>(byte(2) & 0x3F) << 6) | (byte(3) & 0x3F), 4 };
+    }
+
+    return {};
+  }
+
+  // Writes 1 to 4 bytes, returns how many (0 for surrogates and out of range values)
+  constexpr u32 utf8_encode(u32 code_point, char (&out)[4]) noexcept {
+    if (code_point < 0x80) {
+      out[0] = static_cast<char>(code_point);
+      return 1;
+    }
+    else if (code_point < 0x800) {
+      out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+      out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+      return 2;
+    }
+    else if (code_point < 0x10000) {
+      if (code_point >= 0xD800 && code_point <= 0xDFFF) return 0;
+      out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+      out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+      return 3;
+    }
+    else if (code_point <= UNICODE_MAX) {
+      out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+      out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+      out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+      out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+      return 4;
+    }
+    else {
+      return 0;
+    }
+  }
+
+  constexpr bool utf8_validate_scalar(const ViewArr<const char>& str) noexcept {
+    usize i = 0;
+    while (i < str.size) {
+      const UTF8Decode d = utf8_decode(str.data + i, str.size - i);
+      if (d.length == 0) return false;
+      i += d.length;
+    }
+    return true;
+  }
+
+  // Vectorised at runtime, picks the same level as the SIMD string functions
+  bool utf8_validate_runtime(const ViewArr<const char>& str) noexcept;
+
+  constexpr bool utf8_validate(const ViewArr<const char>& str) noexcept {
+    if (std::is_constant_evaluated()) {
+      return utf8_validate_scalar(str);
+    }
+    else {
+      return utf8_validate_runtime(str);
+    }
+  }
+
+  // Walks the code points of a string
+  // Invalid bytes come out one at a time as U+FFFD and set had_error
+  struct CodePointIter {
+    ViewArr<const char> rest = {};
+    bool had_error = false;
+
+    constexpr CodePointIter() = default;
+    constexpr CodePointIter(const ViewArr<const char>& str) : rest(str) {}
+
+    constexpr bool next(u32& code_point) noexcept {
+      if (rest.size == 0) return false;
+
+      const UTF8Decode d = utf8_decode(rest.data, rest.size);
+      if (d.length == 0) {
+        had_error = true;
+        code_point = UNICODE_REPLACEMENT_CHARACTER;
+        rest = { rest.data + 1, rest.size - 1 };
+      }
+      else {
+        code_point = d.code_point;
+        rest = { rest.data + d.length, rest.size - d.length };
+      }
+      return true;
+    }
+  };
+
+  // Both append to out, returning false if the input was invalid
+  // Invalid input is still converted, with U+FFFD in place of the bad sequences
+  bool utf8_to_utf16(const ViewArr<const char>& in, Array<char16_t>& out);
+  bool utf16_to_utf8(const ViewArr<const char16_t>& in, Array<char>& out);
+}
+
+#endif
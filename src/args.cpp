@@ -0,0 +1,13 @@
+#include <AxleUtil/args.h>
+#include <AxleUtil/files.h>
+#include <AxleUtil/tracing_wrapper.h>
+
+namespace clArg {
+  bool read_response_file(const ViewArr<const char>& path, Axle::OwnedArr<u8>& out) {
+    AXLE_UTIL_TELEMETRY_FUNCTION();
+    if (!Axle::FILES::exists(path)) return false;
+
+    out = Axle::FILES::read_full_file(path);
+    return true;
+  }
+}
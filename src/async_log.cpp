@@ -0,0 +1,278 @@
+#include <AxleUtil/async_log.h>
+#include <AxleUtil/threading.h>
+#include <AxleUtil/memory.h>
+#include <AxleUtil/math.h>
+#include <AxleUtil/tracing_wrapper.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace Axle::LOG {
+  namespace {
+    // Records are a u32 length followed by the text, padded to keep the next length aligned
+    // A length of WRAP_MARKER means the rest of the ring was skipped
+    constexpr u32 WRAP_MARKER = 0xFFFFFFFF;
+    constexpr usize RECORD_HEADER = sizeof(u32);
+
+    // Single producer (the owning thread), single consumer (the drain thread)
+    // head and tail only ever increase, masked by capacity to get an offset
+    struct Ring {
+      char* data = nullptr;
+      usize capacity = 0;
+
+      std::atomic<usize> head = 0;
+      usize pending_head = 0;
+
+      // Keep the two ends on separate cache lines (rings come from malloc so alignas wont do)
+      u8 padding[64] = {};
+      std::atomic<usize> tail = 0;
+      std::atomic<usize> written = 0;// tail once the batch holding those records went to the sink
+
+      std::atomic<bool> retired = false;
+      Ring* next = nullptr;
+    };
+
+    void wait_until_written(Ring* ring);
+
+    // Marks the ring as finished when the thread exits, the drain thread frees it once it is empty
+    // Anything logged after that (e.g. from later thread_local destructors) is written synchronously
+    struct ThreadRing {
+      Ring* ring = nullptr;
+      bool exited = false;
+
+      ~ThreadRing() {
+        if (ring != nullptr) {
+          wait_until_written(ring);
+          ring->retired.store(true, std::memory_order_release);
+          ring = nullptr;
+        }
+        exited = true;
+      }
+    };
+
+    struct DrainedRing {
+      Ring* ring;
+      usize tail;
+    };
+
+    struct AsyncLogger {
+      std::atomic<bool> running = false;
+      std::atomic<u64> dropped = 0;
+      AsyncConfig config = {};
+
+      // Rings live across start/stop so a thread's pointer is never left dangling
+      Mutex rings_mutex = {};
+      Ring* rings = nullptr;
+
+      const ThreadHandle* drain_thread = nullptr;
+      Array<char> batch = {};
+      Array<DrainedRing> drained = {};
+    };
+
+    AsyncLogger logger = {};
+    thread_local ThreadRing thread_ring = {};
+
+    Ring* new_ring(usize capacity) {
+      ASSERT(capacity >= 256 && (capacity & (capacity - 1)) == 0);
+
+      Ring* ring = allocate_default<Ring>();
+      ring->data = allocate_default<char>(capacity);
+      ring->capacity = capacity;
+      return ring;
+    }
+
+    void free_ring(Ring* ring) {
+      free_destruct_n<char>(ring->data, ring->capacity);
+      free_destruct_single<Ring>(ring);
+    }
+
+    Ring* this_thread_ring() {
+      Ring* ring = thread_ring.ring;
+      if (ring != nullptr || thread_ring.exited) return ring;
+
+      ring = new_ring(logger.config.ring_size);
+
+      logger.rings_mutex.acquire();
+      ring->next = logger.rings;
+      logger.rings = ring;
+      logger.rings_mutex.release();
+
+      thread_ring.ring = ring;
+      return ring;
+    }
+
+    // Appends every complete record to the batch and frees up their space
+    void drain_ring(Ring* ring, Array<char>& batch) {
+      const usize mask = ring->capacity - 1;
+      usize t = ring->tail.load(std::memory_order_relaxed);
+      const usize h = ring->head.load(std::memory_order_acquire);
+
+      while (t != h) {
+        const usize offset = t & mask;
+
+        u32 size;
+        std::memcpy(&size, ring->data + offset, sizeof(u32));
+
+        if (size == WRAP_MARKER) {
+          t += ring->capacity - offset;
+          continue;
+        }
+
+        batch.concat(ViewArr<const char>{ ring->data + offset + RECORD_HEADER, size });
+        t += ceil_to_N<RECORD_HEADER>(RECORD_HEADER + size);
+      }
+
+      ring->tail.store(t, std::memory_order_release);
+    }
+
+    void write_batch(const ViewArr<const char>& batch) {
+      if (logger.config.sink != nullptr) {
+        logger.config.sink(batch, logger.config.sink_data);
+      }
+      else {
+        IO_Single::ScopeLock lock;
+        IO_Single::err_print(batch);
+      }
+    }
+
+    bool drain_all() {
+      AXLE_UTIL_TELEMETRY_FUNCTION();
+      Array<char>& batch = logger.batch;
+
+      logger.rings_mutex.acquire();
+      Ring** link = &logger.rings;
+      while (*link != nullptr) {
+        Ring* ring = *link;
+
+        // Load before draining, anything written before retiring is then guaranteed to be seen
+        const bool retired = ring->retired.load(std::memory_order_acquire);
+        drain_ring(ring, batch);
+
+        if (retired) {
+          *link = ring->next;
+          free_ring(ring);
+        }
+        else {
+          logger.drained.insert({ ring, ring->tail.load(std::memory_order_relaxed) });
+          link = &ring->next;
+        }
+      }
+      logger.rings_mutex.release();
+
+      const bool wrote = batch.size > 0;
+      if (wrote) {
+        write_batch(const_view_arr(batch));
+        batch.clear();
+      }
+
+      // Only retired rings are freed and those are never in here
+      for (const DrainedRing& d : logger.drained) {
+        d.ring->written.store(d.tail, std::memory_order_release);
+      }
+      logger.drained.clear();
+
+      return wrote;
+    }
+
+    // Records written synchronously must not overtake ones still waiting in the ring
+    void wait_until_written(Ring* ring) {
+      const usize h = ring->head.load(std::memory_order_relaxed);
+      while (ring->written.load(std::memory_order_acquire) != h) {
+        // Nobody is going to write them any more, stop_async drains what is left
+        if (!logger.running.load(std::memory_order_acquire)) return;
+        std::this_thread::yield();
+      }
+    }
+
+    void drain_thread_proc(const ThreadHandle*, AsyncLogger* l) {
+      while (l->running.load(std::memory_order_acquire)) {
+        if (!drain_all()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(l->config.idle_sleep_ms));
+        }
+      }
+
+      drain_all();
+    }
+  }
+
+  bool is_async() {
+    // Acquire so a caller that sees true also sees the config written before it
+    return logger.running.load(std::memory_order_acquire);
+  }
+
+  AsyncSlot async_reserve(usize size) {
+    const usize needed = ceil_to_N<RECORD_HEADER>(RECORD_HEADER + size);
+
+    Ring* ring = this_thread_ring();
+    if (ring == nullptr) return {};
+    if (needed > ring->capacity / 2) {
+      wait_until_written(ring);
+      return {};
+    }
+
+    const usize mask = ring->capacity - 1;
+    const usize h = ring->head.load(std::memory_order_relaxed);
+    const usize offset = h & mask;
+    const usize to_end = ring->capacity - offset;
+    const bool wraps = to_end < needed;
+    const usize total = wraps ? to_end + needed : needed;
+
+    while (ring->capacity - (h - ring->tail.load(std::memory_order_acquire)) < total) {
+      if (logger.config.policy == AsyncPolicy::Drop) {
+        logger.dropped.fetch_add(1, std::memory_order_relaxed);
+        return { nullptr, true };
+      }
+
+      // Nobody is going to make room any more
+      if (!logger.running.load(std::memory_order_relaxed)) return {};
+      std::this_thread::yield();
+    }
+
+    usize start = offset;
+    if (wraps) {
+      std::memcpy(ring->data + offset, &WRAP_MARKER, sizeof(u32));
+      start = 0;
+    }
+
+    const u32 size32 = static_cast<u32>(size);
+    std::memcpy(ring->data + start, &size32, sizeof(u32));
+
+    ring->pending_head = h + total;
+    return { ring->data + start + RECORD_HEADER, false };
+  }
+
+  void async_commit() {
+    Ring* ring = thread_ring.ring;
+    ASSERT(ring != nullptr);
+    ring->head.store(ring->pending_head, std::memory_order_release);
+  }
+
+  void start_async(const AsyncConfig& config) {
+    AXLE_UTIL_TELEMETRY_FUNCTION();
+    ASSERT(logger.drain_thread == nullptr);
+    ASSERT(config.ring_size >= 256 && (config.ring_size & (config.ring_size - 1)) == 0);
+
+    logger.config = config;
+    logger.dropped.store(0, std::memory_order_relaxed);
+    logger.running.store(true, std::memory_order_release);
+    logger.drain_thread = start_thread<drain_thread_proc>(&logger);
+  }
+
+  void stop_async() {
+    AXLE_UTIL_TELEMETRY_FUNCTION();
+    ASSERT(logger.drain_thread != nullptr);
+
+    logger.running.store(false, std::memory_order_release);
+    wait_for_thread_end(logger.drain_thread);
+    logger.drain_thread = nullptr;
+
+    // Rings retired after the drain thread's last pass would otherwise be kept until the next start
+    drain_all();
+  }
+
+  u64 dropped_count() {
+    return logger.dropped.load(std::memory_order_relaxed);
+  }
+}
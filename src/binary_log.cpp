@@ -0,0 +1,261 @@
+#include <AxleUtil/binary_log.h>
+#include <AxleUtil/tracing_wrapper.h>
+
+#include <atomic>
+
+namespace Axle::LOG {
+  static std::atomic<BinaryLog*> active_binary_log = nullptr;
+
+  void set_binary_log(BinaryLog* log) {
+    active_binary_log.store(log, std::memory_order_release);
+  }
+
+  BinaryLog* binary_log() {
+    return active_binary_log.load(std::memory_order_acquire);
+  }
+
+  BinaryLog::BinaryLog(Sink sink_, void* sink_data_, usize flush_size_)
+    : flush_size(flush_size_), sink(sink_), sink_data(sink_data_)
+  {
+    bytes.concat(BINARY_LOG_MAGIC, array_size(BINARY_LOG_MAGIC));
+    bytes.insert(BINARY_LOG_VERSION);
+  }
+
+  BinaryLog::~BinaryLog() {
+    flush();
+  }
+
+  void BinaryLog::flush() {
+    AXLE_UTIL_TELEMETRY_FUNCTION();
+    mutex.acquire();
+    if (bytes.size > 0) {
+      sink(const_view_arr(bytes), sink_data);
+      bytes.clear();
+    }
+    mutex.release();
+  }
+
+  u32 BinaryLog::format_id(const ViewArr<const char>& format, const ViewArr<const BinaryArg>& types) {
+    const BinaryFormatKey key = { format.data, types.data };
+    const u32* existing = format_ids.get_val(key);
+    if (existing != nullptr) return *existing;
+
+    const u32 id = next_id;
+    next_id += 1;
+    format_ids.insert(key, u32{ id });
+
+    const usize size = 1 + 4 + 1 + types.size + 4 + format.size;
+    Serializer<ViewArr<u8>, ByteOrder::LittleEndian> ser = begin_entry(size);
+    serialize_le(ser, static_cast<u8>(BinaryEntry::Format));
+    serialize_le(ser, id);
+    serialize_le(ser, static_cast<u8>(types.size));
+    for (const BinaryArg t : types) {
+      serialize_le(ser, static_cast<u8>(t));
+    }
+    serialize_log_string(ser, format.data, format.size);
+    ASSERT(ser.view.size == 0);
+    end_entry(size);
+
+    return id;
+  }
+
+  ViewArr<u8> BinaryLog::begin_entry(usize size) {
+    bytes.reserve_extra(size);
+    return { bytes.data + bytes.size, size };
+  }
+
+  void BinaryLog::end_entry(usize size) {
+    bytes.size += size;
+
+    if (bytes.size >= flush_size) {
+      sink(const_view_arr(bytes), sink_data);
+      bytes.clear();
+    }
+  }
+
+  namespace {
+    struct AppendFormatter {
+      Array<char>& out;
+
+      void load_string(const char* str, usize N) {
+        out.concat(str, N);
+      }
+
+      template<usize N>
+      void load_string_lit(const char(&str)[N]) {
+        out.concat(str, N - 1);
+      }
+
+      template<usize N>
+      void load_string_exact(const char(&str)[N]) {
+        out.concat(str, N);
+      }
+
+      void load_char(char c) {
+        out.insert(c);
+      }
+    };
+
+    struct DecodedFormat {
+      ViewArr<const char> str;
+      ViewArr<const u8> types;
+    };
+
+    using Reader = Serializer<ViewArr<const u8>, ByteOrder::LittleEndian>;
+
+    bool read_string(Reader& reader, ViewArr<const char>& str) {
+      u32 len;
+      if (!deserialize_le(reader, len)) return false;
+      if (reader.view.size < len) return false;
+
+      str = { reinterpret_cast<const char*>(reader.view.data), len };
+      reader.view = view_arr(reader.view, len, reader.view.size - len);
+      return true;
+    }
+
+    template<typename T, typename U>
+    bool read_as(Reader& reader, AppendFormatter& result) {
+      U u;
+      if (!deserialize_le(reader, u)) return false;
+      Format::FormatArg<T>::load_string(result, static_cast<T>(u));
+      return true;
+    }
+
+    bool read_arg(Reader& reader, BinaryArg type, AppendFormatter& result) {
+      switch (type) {
+        case BinaryArg::Bool: return read_as<bool, u8>(reader, result);
+        case BinaryArg::Char: return read_as<char, u8>(reader, result);
+        case BinaryArg::U8: return read_as<u8, u8>(reader, result);
+        case BinaryArg::U16: return read_as<u16, u16>(reader, result);
+        case BinaryArg::U32: return read_as<u32, u32>(reader, result);
+        case BinaryArg::U64: return read_as<u64, u64>(reader, result);
+        case BinaryArg::I8: return read_as<i8, u8>(reader, result);
+        case BinaryArg::I16: return read_as<i16, u16>(reader, result);
+        case BinaryArg::I32: return read_as<i32, u32>(reader, result);
+        case BinaryArg::I64: return read_as<i64, u64>(reader, result);
+        case BinaryArg::F32: {
+            u32 u;
+            if (!deserialize_le(reader, u)) return false;
+            Format::FormatArg<float>::load_string(result, std::bit_cast<float>(u));
+            return true;
+          }
+        case BinaryArg::F64: {
+            u64 u;
+            if (!deserialize_le(reader, u)) return false;
+            Format::FormatArg<double>::load_string(result, std::bit_cast<double>(u));
+            return true;
+          }
+        case BinaryArg::String: {
+            ViewArr<const char> str;
+            if (!read_string(reader, str)) return false;
+            result.load_string(str.data, str.size);
+            return true;
+          }
+      }
+
+      return false;
+    }
+
+    // Same rules as the compile time checks, "{}" is an argument and doubled braces are escaped
+    bool decode_record(Reader& reader, const DecodedFormat& format, AppendFormatter& result) {
+      const ViewArr<const char>& str = format.str;
+      usize arg = 0;
+      usize run = 0;
+      usize i = 0;
+      while (i < str.size) {
+        const char c = str[i];
+        if (c != '{' && c != '}') {
+          i += 1;
+          continue;
+        }
+
+        if (i + 1 >= str.size) return false;
+        result.load_string(str.data + run, i - run);
+
+        if (c == '{' && str[i + 1] == '}') {
+          if (arg >= format.types.size) return false;
+          if (!read_arg(reader, static_cast<BinaryArg>(format.types[arg]), result)) return false;
+          arg += 1;
+        }
+        else if (str[i + 1] == c) {
+          result.load_char(c);
+        }
+        else {
+          return false;
+        }
+
+        i += 2;
+        run = i;
+      }
+
+      result.load_string(str.data + run, str.size - run);
+      return arg == format.types.size;
+    }
+  }
+
+  bool decode_binary_log(const ViewArr<const u8>& data, Array<char>& out) {
+    AXLE_UTIL_TELEMETRY_FUNCTION();
+    Reader reader = data;
+
+    u8 magic[array_size(BINARY_LOG_MAGIC)];
+    if (!reader.read_bytes(view_arr(magic))) return false;
+    for (usize i = 0; i < array_size(magic); ++i) {
+      if (magic[i] != BINARY_LOG_MAGIC[i]) return false;
+    }
+
+    u8 version;
+    if (!deserialize_le(reader, version) || version != BINARY_LOG_VERSION) return false;
+
+    Array<DecodedFormat> formats = {};
+    AppendFormatter result = { out };
+
+    while (reader.view.size > 0) {
+      u8 entry;
+      deserialize_le(reader, entry);
+
+      switch (static_cast<BinaryEntry>(entry)) {
+        case BinaryEntry::Format: {
+            u32 id;
+            u8 count;
+            if (!deserialize_le(reader, id) || !deserialize_le(reader, count)) return false;
+            if (id != formats.size || reader.view.size < count) return false;
+
+            DecodedFormat format = {};
+            format.types = view_arr(reader.view, 0, count);
+            reader.view = view_arr(reader.view, count, reader.view.size - count);
+            if (!read_string(reader, format.str)) return false;
+
+            formats.insert(format);
+            break;
+          }
+        case BinaryEntry::Record: {
+            u8 level;
+            u32 id;
+            if (!deserialize_le(reader, level) || !deserialize_le(reader, id)) return false;
+            if (level > static_cast<u8>(Level::Error) || id >= formats.size) return false;
+
+            const ViewArr<const char> prefix = level_prefix(static_cast<Level>(level));
+            result.load_string(prefix.data, prefix.size);
+            if (!decode_record(reader, formats[id], result)) return false;
+            result.load_char('\n');
+            break;
+          }
+        case BinaryEntry::Text: {
+            u8 level;
+            ViewArr<const char> str;
+            if (!deserialize_le(reader, level) || !read_string(reader, str)) return false;
+            if (level > static_cast<u8>(Level::Error)) return false;
+
+            const ViewArr<const char> prefix = level_prefix(static_cast<Level>(level));
+            result.load_string(prefix.data, prefix.size);
+            result.load_string(str.data, str.size);
+            result.load_char('\n');
+            break;
+          }
+        default: return false;
+      }
+    }
+
+    return true;
+  }
+}
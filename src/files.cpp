@@ -8,32 +8,35 @@
 
 namespace Axle {
 FILES::OpenedFile FILES::open(const ViewArr<const char>& name,
-                              OPEN_MODE open_mode) {
+                              OPEN_MODE open_mode,
+                              const BufferOptions& buffer_options) {
   AXLE_UTIL_TELEMETRY_FUNCTION();
 
   Windows::NativePath path = name;
   OpenedFile of;
-  of.error_code = Windows::FILES::open(of.file.data, path, open_mode);
+  of.error_code = Windows::FILES::open(of.file.data, path, open_mode, buffer_options);
   return of;
 }
 
 FILES::OpenedFile FILES::create(const ViewArr<const char>& name,
-                                OPEN_MODE open_mode) {
+                                OPEN_MODE open_mode,
+                                const BufferOptions& buffer_options) {
   AXLE_UTIL_TELEMETRY_FUNCTION();
 
   Windows::NativePath path = name;
   OpenedFile of;
-  of.error_code = Windows::FILES::create(of.file.data, path, open_mode);
+  of.error_code = Windows::FILES::create(of.file.data, path, open_mode, buffer_options);
   return of;
 }
 
 FILES::OpenedFile FILES::replace(const ViewArr<const char>& name,
-                                 OPEN_MODE open_mode) {
+                                 OPEN_MODE open_mode,
+                                 const BufferOptions& buffer_options) {
   AXLE_UTIL_TELEMETRY_FUNCTION();
 
   Windows::NativePath path = name;
   OpenedFile of;
-  of.error_code = Windows::FILES::replace(of.file.data, path, open_mode);
+  of.error_code = Windows::FILES::replace(of.file.data, path, open_mode, buffer_options);
   return of;
 }
 
@@ -94,39 +97,23 @@ FILES::ErrorCode FILES::read_to_bytes(FileHandle file_h, uint8_t* bytes, size_t
 
   FileData* const file = file_h.data;
 
-  Base::BufferRange range = get_loaded_range(file, file->abstract_file_ptr, num_bytes);
+  usize ptr = file->abstract_file_ptr;
+  usize remaining = num_bytes;
 
-  if (num_bytes > range.size) {
-    sync_buffer(file); //always need to sync here
-
-    bool at_buffer_start = range.ptr_start == 0;
-    bool at_buffer_end = range.ptr_start + range.size == num_bytes;
-
-    bool straddles = range.size == FileData::BUFFER_SIZE && (!at_buffer_start || !at_buffer_end);
+  // Anything at the start of the read that is already loaded
+  const usize buffer_end = file->real_buffer_ptr + file->buffer_size;
+  if (file->real_buffer_ptr <= ptr && ptr < buffer_end) {
+    const usize loaded = smaller(buffer_end - ptr, remaining);
+    memcpy_s(bytes, loaded, file->buffer + (ptr - file->real_buffer_ptr), loaded);
 
-    if (straddles) {
-      //straddles the buffer
-      //lets just do-over
-      big_buffer_read(file, file->abstract_file_ptr, bytes, num_bytes);
-    }
-    else if (range.ptr_start == 0) {
-      memcpy_s(bytes, range.size, file->buffer + range.buffer_start, range.size);
-      usize remaining = num_bytes - (usize)range.size;
-      generic_buffer_read(file, file->abstract_file_ptr + range.size,
-                          bytes + range.size, remaining);
-    }
-    else {
-      ASSERT(range.buffer_start == 0);
-      memcpy_s(bytes + range.ptr_start, range.size, file->buffer + range.buffer_start, range.size);
-      usize remaining = range.ptr_start;
-      generic_buffer_read(file, file->abstract_file_ptr, bytes, remaining);
-    }
+    ptr += loaded;
+    bytes += loaded;
+    remaining -= loaded;
   }
-  else {
-    ASSERT(range.size == num_bytes);
-    ASSERT(range.ptr_start == 0);
-    //all is loaded
-    memcpy_s(bytes, num_bytes, file->buffer + range.buffer_start, num_bytes);
+
+  if (remaining > 0) {
+    sync_buffer(file); //always need to sync here
+    generic_buffer_read(file, ptr, bytes, remaining);
   }
 
   file->abstract_file_ptr += num_bytes;
@@ -151,13 +138,23 @@ OwnedArr<u8> FILES::read_full_file(const ViewArr<const char>& file_name) {
   return Windows::FILES::read_full_file(path);
 }
 
+FILES::ErrorCode FILES::map_file(MappedFile& mapped, const ViewArr<const char>& file_name, MAP_MODE map_mode) {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+
+  Windows::NativePath path = file_name;
+  return Windows::FILES::map_file(mapped, path, map_mode);
+}
+
 FILES::ErrorCode FILES::write(FileHandle file_h, const uint8_t* bytes, size_t num_bytes) {
   FileData* const file = file_h.data;
 
   usize end = file->abstract_file_ptr + num_bytes;
-  usize max_buffer_end = file->real_buffer_ptr + FileData::BUFFER_SIZE;
+  usize max_buffer_end = file->real_buffer_ptr + file->buffer_capacity;
 
-  if (file->real_buffer_ptr <= file->abstract_file_ptr && end <= max_buffer_end) {
+  // Must carry on from what is loaded, otherwise the gap would be written out too
+  if (file->real_buffer_ptr <= file->abstract_file_ptr
+      && file->abstract_file_ptr <= file->real_buffer_ptr + file->buffer_size
+      && end <= max_buffer_end) {
     usize start = (file->abstract_file_ptr - file->real_buffer_ptr);
 
     //write over part of the buffer
@@ -182,6 +179,42 @@ FILES::ErrorCode FILES::write(FileHandle file_h, const uint8_t* bytes, size_t nu
   return ErrorCode::OK;
 }
 
+FILES::BufferedFileFormatter::BufferedFileFormatter(FileHandle handle_, usize buffer_size)
+  : handle(handle_), buffer(new_arr<u8>(buffer_size)) {
+  ASSERT(buffer_size > 0);
+}
+
+FILES::BufferedFileFormatter::~BufferedFileFormatter() {
+  flush();
+}
+
+FILES::ErrorCode FILES::BufferedFileFormatter::flush() {
+  if (is_ok() && used > 0) {
+    errors = write(handle, buffer.data, used);
+  }
+  used = 0;
+  return errors;
+}
+
+void FILES::BufferedFileFormatter::load_string(const char* str, usize N) {
+  ASSERT(N > 0);
+  if (!is_ok()) return;
+
+  if (N > buffer.size - used) {
+    flush();
+    if (!is_ok()) return;
+
+    // Too big to be worth copying, write it straight through
+    if (N >= buffer.size) {
+      errors = write(handle, reinterpret_cast<const u8*>(str), N);
+      return;
+    }
+  }
+
+  memcpy_ts(buffer.data + used, buffer.size - used, reinterpret_cast<const u8*>(str), N);
+  used += N;
+}
+
 FILES::ErrorCode FILES::write_padding_bytes(FileHandle file_h, uint8_t byte, size_t num) {
   //TODO: actual buffered io
   FileData* const file = file_h.data;
@@ -189,25 +222,22 @@ FILES::ErrorCode FILES::write_padding_bytes(FileHandle file_h, uint8_t byte, siz
   sync_buffer(file);
   seek_from_start_internal(file, file->abstract_file_ptr);
 
-  usize remaining = num;
-
-  while (remaining > FileData::BUFFER_SIZE) {
-    memset(file->buffer, byte, FileData::BUFFER_SIZE);
-    file->buffer_size = FileData::BUFFER_SIZE;
-    file->real_buffer_ptr = file->abstract_file_ptr;
-    force_sync_buffer(file);
-
-    remaining -= FileData::BUFFER_SIZE;
+  const usize end = file->abstract_file_ptr + num;
+  if (file->abstract_file_size < end) {
+    file->abstract_file_size = end;
   }
 
-  if (num > 0) {
-    memset(file->buffer, byte, remaining);
-    file->buffer_size = (u32)remaining;
+  usize remaining = num;
+  while (remaining > 0) {
+    const usize size = smaller<usize>(remaining, file->buffer_capacity);
+    memset(file->buffer, byte, size);
+    file->buffer_size = (u32)size;
     file->real_buffer_ptr = file->abstract_file_ptr;
     force_sync_buffer(file);
-  }
 
-  file->abstract_file_ptr += num;
+    file->abstract_file_ptr += size;
+    remaining -= size;
+  }
 
   return ErrorCode::OK;
 }
@@ -300,32 +330,24 @@ static void append_single_to_path(Array<ViewArr<const char>>& path, const ViewAr
 }
 
 static ViewArr<const char> append_path_to_path(Array<ViewArr<const char>>& path, const ViewArr<const char>& dir) {
+  constexpr ViewArr<const char> separators = lit_view_arr("/\\");
+
   usize start = 0;
-  usize i = 0;
 
-  while (i < dir.size) {
-    if (dir[i] == '/' || dir[i] == '\\') {
-      append_single_to_path(path, view_arr(dir, start, i - start));
+  while (true) {
+    const char* sep = find_any_of(view_arr(dir, start, dir.size - start), separators);
+    if (sep == nullptr) break;
 
-      i += 1;
-      start = i;
-    }
-    else {
-      i += 1;
-    }
+    const usize i = static_cast<usize>(sep - dir.data);
+    append_single_to_path(path, view_arr(dir, start, i - start));
+    start = i + 1;
   }
 
-  return view_arr(dir, start, i - start);
+  return view_arr(dir, start, dir.size - start);
 }
 
 static const char* find_dot_in_file_name(const char* start, const char* end) {
-  while (start < end) {
-    if (*start == '.') return start;
-
-    start += 1;
-  }
-
-  return nullptr;
+  return find_byte({ start, static_cast<usize>(end - start) }, '.');
 }
 
 OwnedArr<const char> normalize_path(const ViewArr<const char>& path_str) {
@@ -0,0 +1,78 @@
+#include <AxleUtil/hash.h>
+#include <AxleUtil/format.h>
+#include <AxleUtil/io.h>
+
+#ifdef AXLE_HASH_STATS
+#include <AxleUtil/threading.h>
+#endif
+
+namespace Axle::Hash {
+#ifdef AXLE_HASH_STATS
+namespace {
+  struct LiveTableList {
+    Mutex mutex = {};
+    LiveTable* head = nullptr;
+
+    void dump() {
+      IO_Single::ScopeLock io_lock;
+
+      for (const LiveTable* t = head; t != nullptr; t = t->next) {
+        const HashTableStats stats = t->collect(t->table);
+        Format::STErrPrintFormatter res = {};
+        Format::format_to(res, "HASH STATS | {} ({}): {}\n",
+                          Format::CString{ t->type_name }, Format::PrintPtr{ t->table }, stats);
+      }
+    }
+  };
+
+  LiveTableList& live_tables() {
+    static LiveTableList list = {};
+    return list;
+  }
+}
+
+void register_live_table(LiveTable* t) noexcept {
+  LiveTableList& list = live_tables();
+  list.mutex.acquire();
+
+  t->prev = nullptr;
+  t->next = list.head;
+  if (list.head != nullptr) {
+    list.head->prev = t;
+  }
+  list.head = t;
+
+  list.mutex.release();
+}
+
+void unregister_live_table(LiveTable* t) noexcept {
+  LiveTableList& list = live_tables();
+  list.mutex.acquire();
+
+  if (t->prev != nullptr) {
+    t->prev->next = t->next;
+  }
+  else if (list.head == t) {
+    list.head = t->next;
+  }
+
+  if (t->next != nullptr) {
+    t->next->prev = t->prev;
+  }
+
+  t->prev = nullptr;
+  t->next = nullptr;
+
+  list.mutex.release();
+}
+
+void dump_live_table_stats() {
+  LiveTableList& list = live_tables();
+  list.mutex.acquire();
+  list.dump();
+  list.mutex.release();
+}
+#else
+void dump_live_table_stats() {}
+#endif
+}
@@ -1,14 +1,142 @@
 #include <AxleUtil/io.h>
 #include <AxleUtil/threading.h>
+#include <AxleUtil/memory.h>
 #include <AxleUtil/tracing_wrapper.h>
 
 #include <cstdio>
+#include <cstring>
 namespace Axle {
 static Mutex io_mutex = {};
 
+namespace {
+  struct ThreadOutput {
+    static constexpr usize BUFFER_SIZE = 16 * 1024;
+
+    FILE* file;
+    u32 flush_lines;
+    ThreadOutput* write_first;// written out before this one so its earlier lines are not overtaken
+
+    u32 lines = 0;
+    usize used = 0;
+    usize complete = 0;// end of the last full line
+    char* data = nullptr;// only allocated once the thread prints something
+
+    ThreadOutput(FILE* file_, u32 flush_lines_, ThreadOutput* write_first_ = nullptr)
+      : file(file_), flush_lines(flush_lines_), write_first(write_first_) {}
+
+    ThreadOutput(const ThreadOutput&) = delete;
+    ThreadOutput& operator=(const ThreadOutput&) = delete;
+
+    ~ThreadOutput() {
+      write_out(used);
+      free_destruct_n<char>(data, BUFFER_SIZE);
+      data = nullptr;
+    }
+
+    // Writes the first n bytes and keeps the rest, which never holds a full line
+    void write_out(usize n) {
+      AXLE_UTIL_TELEMETRY_FUNCTION();
+      if (n == 0) return;
+      if (write_first != nullptr) write_first->write_out(write_first->used);
+
+      io_mutex.acquire();
+      if (write_first != nullptr) fflush(write_first->file);
+      fwrite(data, 1, n, file);
+      io_mutex.release();
+
+      used -= n;
+      std::memmove(data, data + n, used);
+      complete = 0;
+      lines = 0;
+    }
+
+    void append(const char* string, usize n) {
+      if (n == 0) return;
+      if (data == nullptr) {
+        data = allocate_default<char>(BUFFER_SIZE);
+      }
+
+      while (n > 0) {
+        if (used == BUFFER_SIZE) {
+          // A single line bigger than the buffer has to be split up
+          write_out(complete > 0 ? complete : used);
+        }
+
+        const usize count = smaller(n, BUFFER_SIZE - used);
+        memcpy_ts(data + used, BUFFER_SIZE - used, string, count);
+
+        for (usize i = 0; i < count; ++i) {
+          if (string[i] == '\n') {
+            lines += 1;
+            complete = used + i + 1;
+          }
+        }
+
+        used += count;
+        string += count;
+        n -= count;
+
+        if (lines >= flush_lines) {
+          write_out(complete);
+        }
+      }
+    }
+  };
+
+  thread_local ThreadOutput thread_out = { stdout, 32 };
+  thread_local ThreadOutput thread_err = { stderr, 1, &thread_out };
+
+  ThreadOutput& thread_output(IO::Stream stream) {
+    return stream == IO::Stream::Out ? thread_out : thread_err;
+  }
+}
+
+void IO::write(Stream stream, const char* string, usize n) {
+  thread_output(stream).append(string, n);
+}
+
+void IO::write(Stream stream, char c) {
+  thread_output(stream).append(&c, 1);
+}
+
+void IO::end_print(Stream stream) {
+  ThreadOutput& out = thread_output(stream);
+  if (out.used > out.complete) {
+    out.write_out(out.used);
+  }
+}
+
+void IO::flush() {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+  thread_out.write_out(thread_out.used);
+  thread_err.write_out(thread_err.used);
+
+  io_mutex.acquire();
+  fflush(stdout);
+  fflush(stderr);
+  io_mutex.release();
+}
+
+void IO::set_flush_lines(Stream stream, u32 lines) {
+  ASSERT(lines > 0);
+  thread_output(stream).flush_lines = lines;
+}
+
+void IO::set_output(Stream stream, FILE* file) {
+  ASSERT(file != nullptr);
+  ThreadOutput& out = thread_output(stream);
+  out.write_out(out.used);
+  out.file = file;
+}
+
 void IO_Single::lock() {
   AXLE_UTIL_TELEMETRY_FUNCTION();
+  // Whatever this thread buffered came before anything it writes under the lock
+  thread_out.write_out(thread_out.used);
+  thread_err.write_out(thread_err.used);
+
   io_mutex.acquire();
+  fflush(thread_out.file);
 }
 
 void IO_Single::unlock() {
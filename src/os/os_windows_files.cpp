@@ -47,11 +47,25 @@ namespace Axle::FILES::Base {
   }
 }
 
+namespace Axle::FILES {
+  void MappedFile::close() noexcept {
+    if (native_mapping != nullptr) {
+      UnmapViewOfFile(data);
+      CloseHandle(static_cast<HANDLE>(native_mapping));
+    }
+
+    data = nullptr;
+    size = 0;
+    native_mapping = nullptr;
+  }
+}
+
 namespace Axle::Windows::FILES {
 
 ErrorCode open(FileData*& data,
                const NativePath& name,
-               OPEN_MODE open_mode) {
+               OPEN_MODE open_mode,
+               const BufferOptions& buffer_options) {
   DWORD access;
   DWORD share;
 
@@ -78,10 +92,10 @@ ErrorCode open(FileData*& data,
   }
   else {
     if(data == nullptr) {
-      data = allocate_single_constructed<FileData>(h);
+      data = allocate_single_constructed<FileData>(h, buffer_options);
     }
     else {
-      Axle::reset_type<FileData>(data, h);
+      Axle::reset_type<FileData>(data, h, buffer_options);
     }
 
     return ErrorCode::OK;
@@ -90,7 +104,8 @@ ErrorCode open(FileData*& data,
 
 ErrorCode create(FileData*& data,
                  const NativePath& name,
-                 OPEN_MODE open_mode) {
+                 OPEN_MODE open_mode,
+                 const BufferOptions& buffer_options) {
   DWORD access;
   DWORD share;
 
@@ -117,10 +132,10 @@ ErrorCode create(FileData*& data,
   }
   else {
     if(data == nullptr) {
-      data = allocate_single_constructed<FileData>(h);
+      data = allocate_single_constructed<FileData>(h, buffer_options);
     }
     else {
-      Axle::reset_type<FileData>(data, h);
+      Axle::reset_type<FileData>(data, h, buffer_options);
     }
 
     return ErrorCode::OK;
@@ -129,7 +144,8 @@ ErrorCode create(FileData*& data,
 
 ErrorCode replace(FileData*& data,
                   const NativePath& name,
-                  OPEN_MODE open_mode) {
+                  OPEN_MODE open_mode,
+                  const BufferOptions& buffer_options) {
   DWORD access;
   DWORD share;
 
@@ -155,10 +171,10 @@ ErrorCode replace(FileData*& data,
   }
   else {
     if(data == nullptr) {
-      data = allocate_single_constructed<FileData>(h);
+      data = allocate_single_constructed<FileData>(h, buffer_options);
     }
     else {
-      Axle::reset_type<FileData>(data, h);
+      Axle::reset_type<FileData>(data, h, buffer_options);
     }
 
     return ErrorCode::OK;
@@ -197,6 +213,57 @@ OwnedArr<u8> read_full_file(const NativePath& file_name) {
   return { data, size };
 }
 
+ErrorCode map_file(Axle::FILES::MappedFile& mapped,
+                   const NativePath& file_name,
+                   MAP_MODE map_mode) {
+  DWORD protect;
+  DWORD access;
+
+  switch (map_mode) {
+    case MAP_MODE::READ_ONLY: {
+        protect = PAGE_READONLY;
+        access = FILE_MAP_READ;
+        break;
+      }
+    case MAP_MODE::COPY_ON_WRITE: {
+        protect = PAGE_WRITECOPY;
+        access = FILE_MAP_COPY;
+        break;
+      }
+    default: {
+      INVALID_CODE_PATH("Invalid Map Mode");
+    }
+  }
+
+  mapped.close();
+
+  HANDLE h = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, 0, 0);
+  if (h == INVALID_HANDLE_VALUE) return ErrorCode::COULD_NOT_OPEN_FILE;
+  DEFER(h) { CloseHandle(h); };
+
+  LARGE_INTEGER li = {};
+  GetFileSizeEx(h, &li);
+  ASSERT(li.QuadPart >= 0);
+
+  // Cannot map an empty file
+  if (li.QuadPart == 0) return ErrorCode::OK;
+
+  // The view keeps the file open after these handles close
+  HANDLE mapping = CreateFileMappingA(h, NULL, protect, 0, 0, NULL);
+  if (mapping == NULL) return ErrorCode::COULD_NOT_MAP_FILE;
+
+  void* view = MapViewOfFile(mapping, access, 0, 0, 0);
+  if (view == NULL) {
+    CloseHandle(mapping);
+    return ErrorCode::COULD_NOT_MAP_FILE;
+  }
+
+  mapped.data = static_cast<u8*>(view);
+  mapped.size = static_cast<usize>(li.QuadPart);
+  mapped.native_mapping = mapping;
+  return ErrorCode::OK;
+}
+
   DirectoryIterator::DirectoryIterator(DirectoryIterator&& d) noexcept : data(std::move(d.data)), find_handle(std::exchange(d.find_handle, INVALID_HANDLE_VALUE)) {}
 
   DirectoryIterator& DirectoryIterator::operator=(DirectoryIterator&& d) noexcept {
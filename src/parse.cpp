@@ -0,0 +1,26 @@
+#include <AxleUtil/parse.h>
+
+#include <charconv>
+
+namespace Axle {
+  // from_chars already does the exact fast path for floats, it just needs the whole string used up
+  template<typename T>
+  static bool parse_float(const ViewArr<const char>& str, T& out) {
+    if (str.size == 0) return false;
+
+    T v;
+    const std::from_chars_result res = std::from_chars(str.data, str.data + str.size, v);
+    if (res.ec != std::errc{} || res.ptr != str.data + str.size) return false;
+
+    out = v;
+    return true;
+  }
+
+  bool parse_number(const ViewArr<const char>& str, float& out) {
+    return parse_float(str, out);
+  }
+
+  bool parse_number(const ViewArr<const char>& str, double& out) {
+    return parse_float(str, out);
+  }
+}
@@ -0,0 +1,467 @@
+#include <AxleUtil/simd.h>
+#include <AxleUtil/safe_lib.h>
+
+#include <intrin.h>
+#include <immintrin.h>
+
+#include <atomic>
+#include <bit>
+#include <cstring>
+
+// strlen and streq read whole vectors that can extend past the end of the string
+// They never cross a page boundary so cannot fault, but asan cannot know that
+#define AXLE_SIMD_NO_ASAN __declspec(no_sanitize_address)
+
+namespace Axle::SIMD {
+namespace {
+  constexpr usize PAGE_SIZE = 4096;
+
+  constexpr usize page_offset(const void* p) noexcept {
+    return reinterpret_cast<uintptr_t>(p) & (PAGE_SIZE - 1);
+  }
+
+  template<typename T>
+  T load_unaligned(const u8* p) noexcept {
+    T t;
+    std::memcpy(&t, p, sizeof(T));
+    return t;
+  }
+
+  namespace Scalar {
+    bool memeq(const u8* a, const u8* b, usize len) noexcept {
+      for (usize i = 0; i < len; ++i) {
+        if (a[i] != b[i]) return false;
+      }
+      return true;
+    }
+
+    usize mismatch(const u8* a, const u8* b, usize len) noexcept {
+      for (usize i = 0; i < len; ++i) {
+        if (a[i] != b[i]) return i;
+      }
+      return len;
+    }
+
+    usize strlen(const char* str) noexcept {
+      const char* c = str;
+      while (*c != '\0') c += 1;
+      return static_cast<usize>(c - str);
+    }
+
+    bool streq(const char* a, const char* b) noexcept {
+      while (a[0] != '\0' && a[0] == b[0]) {
+        a += 1;
+        b += 1;
+      }
+      return a[0] == b[0];
+    }
+
+    const u8* find_byte(const u8* data, usize len, u8 byte) noexcept {
+      for (usize i = 0; i < len; ++i) {
+        if (data[i] == byte) return data + i;
+      }
+      return nullptr;
+    }
+
+    const u8* find_any_of(const u8* data, usize len, const u8* set, usize set_len) noexcept {
+      bool in_set[256] = {};
+      for (usize i = 0; i < set_len; ++i) {
+        in_set[set[i]] = true;
+      }
+
+      for (usize i = 0; i < len; ++i) {
+        if (in_set[data[i]]) return data + i;
+      }
+      return nullptr;
+    }
+
+    const u8* find_substring(const u8* data, usize len, const u8* sub, usize sub_len) noexcept {
+      if (sub_len == 0) return data;
+      if (sub_len > len) return nullptr;
+
+      const usize last_start = len - sub_len;
+      for (usize i = 0; i <= last_start; ++i) {
+        if (data[i] == sub[0] && memeq(data + i + 1, sub + 1, sub_len - 1)) return data + i;
+      }
+      return nullptr;
+    }
+  }
+
+  // Strings shorter than a vector
+  bool memeq_small(const u8* a, const u8* b, usize len) noexcept {
+    if (len >= 8) {
+      // Two overlapping loads cover 8 to 16 bytes
+      return load_unaligned<u64>(a) == load_unaligned<u64>(b)
+        && load_unaligned<u64>(a + len - 8) == load_unaligned<u64>(b + len - 8);
+    }
+    else if (len >= 4) {
+      return load_unaligned<u32>(a) == load_unaligned<u32>(b)
+        && load_unaligned<u32>(a + len - 4) == load_unaligned<u32>(b + len - 4);
+    }
+    else {
+      return Scalar::memeq(a, b, len);
+    }
+  }
+
+  struct V128 {
+    using Reg = __m128i;
+    constexpr static usize WIDTH = 16;
+    constexpr static u32 FULL_MASK = 0xFFFF;
+
+    static Reg load(const u8* p) noexcept { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Reg loadu(const u8* p) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static Reg set1(u8 b) noexcept { return _mm_set1_epi8(static_cast<char>(b)); }
+
+    // bit i set if byte i of a and b are equal
+    static u32 eq_mask(Reg a, Reg b) noexcept {
+      return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+    }
+  };
+
+  struct V256 {
+    using Reg = __m256i;
+    constexpr static usize WIDTH = 32;
+    constexpr static u32 FULL_MASK = 0xFFFFFFFF;
+
+    static Reg load(const u8* p) noexcept { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Reg loadu(const u8* p) noexcept { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static Reg set1(u8 b) noexcept { return _mm256_set1_epi8(static_cast<char>(b)); }
+
+    static u32 eq_mask(Reg a, Reg b) noexcept {
+      return static_cast<u32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    }
+  };
+
+  template<typename V>
+  bool memeq_kernel(const u8* a, const u8* b, usize len) noexcept {
+    constexpr usize W = V::WIDTH;
+    if (len < W) {
+      if constexpr (W > V128::WIDTH) {
+        return memeq_kernel<V128>(a, b, len);
+      }
+      else {
+        return memeq_small(a, b, len);
+      }
+    }
+
+    usize i = 0;
+    for (; i + W <= len; i += W) {
+      if (V::eq_mask(V::loadu(a + i), V::loadu(b + i)) != V::FULL_MASK) return false;
+    }
+
+    // Last block overlaps bytes that already matched
+    if (i < len) {
+      return V::eq_mask(V::loadu(a + len - W), V::loadu(b + len - W)) == V::FULL_MASK;
+    }
+    return true;
+  }
+
+  template<typename V>
+  usize mismatch_kernel(const u8* a, const u8* b, usize len) noexcept {
+    constexpr usize W = V::WIDTH;
+    if (len < W) {
+      if constexpr (W > V128::WIDTH) {
+        return mismatch_kernel<V128>(a, b, len);
+      }
+      else {
+        return Scalar::mismatch(a, b, len);
+      }
+    }
+
+    usize i = 0;
+    for (; i + W <= len; i += W) {
+      const u32 diff = ~V::eq_mask(V::loadu(a + i), V::loadu(b + i)) & V::FULL_MASK;
+      if (diff != 0) return i + std::countr_zero(diff);
+    }
+
+    if (i < len) {
+      const usize start = len - W;
+      const u32 diff = ~V::eq_mask(V::loadu(a + start), V::loadu(b + start)) & V::FULL_MASK;
+      if (diff != 0) return start + std::countr_zero(diff);
+    }
+    return len;
+  }
+
+  // Aligned loads never cross a page so can safely read past the terminator
+  template<typename V>
+  AXLE_SIMD_NO_ASAN usize strlen_kernel(const char* str) noexcept {
+    constexpr usize W = V::WIDTH;
+    const typename V::Reg zero = V::set1(0);
+
+    const u8* const start = reinterpret_cast<const u8*>(str);
+    const usize misalign = reinterpret_cast<uintptr_t>(start) & (W - 1);
+    const u8* block = start - misalign;
+
+    // Ignore the bytes before the string in the first block
+    const u32 first = V::eq_mask(V::load(block), zero) >> misalign;
+    if (first != 0) return std::countr_zero(first);
+
+    while (true) {
+      block += W;
+      const u32 zeros = V::eq_mask(V::load(block), zero);
+      if (zeros != 0) return static_cast<usize>(block - start) + std::countr_zero(zeros);
+    }
+  }
+
+  template<typename V>
+  AXLE_SIMD_NO_ASAN bool streq_kernel(const char* a_str, const char* b_str) noexcept {
+    constexpr usize W = V::WIDTH;
+    const typename V::Reg zero = V::set1(0);
+
+    const u8* a = reinterpret_cast<const u8*>(a_str);
+    const u8* b = reinterpret_cast<const u8*>(b_str);
+
+    while (true) {
+      if (page_offset(a) <= PAGE_SIZE - W && page_offset(b) <= PAGE_SIZE - W) {
+        const typename V::Reg va = V::loadu(a);
+        const typename V::Reg vb = V::loadu(b);
+
+        // Stop at the first difference or the first end of a
+        const u32 diff = ~V::eq_mask(va, vb) & V::FULL_MASK;
+        const u32 ends = V::eq_mask(va, zero);
+        const u32 stop = diff | ends;
+        if (stop != 0) {
+          const usize i = std::countr_zero(stop);
+          return a[i] == b[i];
+        }
+
+        a += W;
+        b += W;
+      }
+      else {
+        // Too close to a page boundary for a full load
+        if (*a != *b) return false;
+        if (*a == '\0') return true;
+        a += 1;
+        b += 1;
+      }
+    }
+  }
+
+  template<typename V>
+  const u8* find_byte_kernel(const u8* data, usize len, u8 byte) noexcept {
+    constexpr usize W = V::WIDTH;
+    if (len < W) {
+      if constexpr (W > V128::WIDTH) {
+        return find_byte_kernel<V128>(data, len, byte);
+      }
+      else {
+        return Scalar::find_byte(data, len, byte);
+      }
+    }
+
+    const typename V::Reg needle = V::set1(byte);
+
+    usize i = 0;
+    for (; i + W <= len; i += W) {
+      const u32 found = V::eq_mask(V::loadu(data + i), needle);
+      if (found != 0) return data + i + std::countr_zero(found);
+    }
+
+    if (i < len) {
+      const usize start = len - W;
+      const u32 found = V::eq_mask(V::loadu(data + start), needle);
+      if (found != 0) return data + start + std::countr_zero(found);
+    }
+    return nullptr;
+  }
+
+  // Larger sets are faster with the scalar lookup table
+  constexpr usize MAX_VECTOR_SET = 16;
+
+  template<typename V>
+  const u8* find_any_of_kernel(const u8* data, usize len, const u8* set, usize set_len) noexcept {
+    constexpr usize W = V::WIDTH;
+    if (len < W || set_len > MAX_VECTOR_SET) {
+      if constexpr (W > V128::WIDTH) {
+        if (set_len <= MAX_VECTOR_SET) return find_any_of_kernel<V128>(data, len, set, set_len);
+      }
+      return Scalar::find_any_of(data, len, set, set_len);
+    }
+
+    if (set_len == 0) return nullptr;
+
+    typename V::Reg needles[MAX_VECTOR_SET];
+    for (usize s = 0; s < set_len; ++s) {
+      needles[s] = V::set1(set[s]);
+    }
+
+    const auto block_mask = [&](const u8* p) {
+      const typename V::Reg v = V::loadu(p);
+      u32 found = 0;
+      for (usize s = 0; s < set_len; ++s) {
+        found |= V::eq_mask(v, needles[s]);
+      }
+      return found;
+    };
+
+    usize i = 0;
+    for (; i + W <= len; i += W) {
+      const u32 found = block_mask(data + i);
+      if (found != 0) return data + i + std::countr_zero(found);
+    }
+
+    if (i < len) {
+      const usize start = len - W;
+      const u32 found = block_mask(data + start);
+      if (found != 0) return data + start + std::countr_zero(found);
+    }
+    return nullptr;
+  }
+
+  // Compares the first and last byte of sub at W positions at once
+  // and only checks the middle where both match
+  template<typename V>
+  const u8* find_substring_kernel(const u8* data, usize len, const u8* sub, usize sub_len) noexcept {
+    constexpr usize W = V::WIDTH;
+    if (sub_len == 0) return data;
+    if (sub_len > len) return nullptr;
+    if (sub_len == 1) return find_byte_kernel<V>(data, len, sub[0]);
+
+    const typename V::Reg first = V::set1(sub[0]);
+    const typename V::Reg last = V::set1(sub[sub_len - 1]);
+    const usize last_start = len - sub_len;
+
+    usize i = 0;
+    for (; i + W <= last_start + 1; i += W) {
+      u32 candidates = V::eq_mask(V::loadu(data + i), first)
+        & V::eq_mask(V::loadu(data + i + sub_len - 1), last);
+
+      while (candidates != 0) {
+        const usize at = i + std::countr_zero(candidates);
+        if (memeq_kernel<V>(data + at + 1, sub + 1, sub_len - 2)) return data + at;
+        candidates &= candidates - 1;
+      }
+    }
+
+    for (; i <= last_start; ++i) {
+      if (data[i] == sub[0] && data[i + sub_len - 1] == sub[sub_len - 1]
+          && memeq_kernel<V>(data + i + 1, sub + 1, sub_len - 2)) {
+        return data + i;
+      }
+    }
+    return nullptr;
+  }
+
+  struct Kernels {
+    Level level;
+    bool(*memeq)(const u8*, const u8*, usize) noexcept;
+    usize(*mismatch)(const u8*, const u8*, usize) noexcept;
+    usize(*strlen)(const char*) noexcept;
+    bool(*streq)(const char*, const char*) noexcept;
+    const u8* (*find_byte)(const u8*, usize, u8) noexcept;
+    const u8* (*find_any_of)(const u8*, usize, const u8*, usize) noexcept;
+    const u8* (*find_substring)(const u8*, usize, const u8*, usize) noexcept;
+  };
+
+  constexpr Kernels SCALAR_KERNELS = {
+    Level::Scalar,
+    &Scalar::memeq, &Scalar::mismatch, &Scalar::strlen, &Scalar::streq,
+    &Scalar::find_byte, &Scalar::find_any_of, &Scalar::find_substring,
+  };
+
+  template<typename V>
+  constexpr Kernels vector_kernels(Level level) {
+    return {
+      level,
+      &memeq_kernel<V>, &mismatch_kernel<V>, &strlen_kernel<V>, &streq_kernel<V>,
+      &find_byte_kernel<V>, &find_any_of_kernel<V>, &find_substring_kernel<V>,
+    };
+  }
+
+  constexpr Kernels SSE2_KERNELS = vector_kernels<V128>(Level::SSE2);
+  // strlen and streq are usually short enough that the wider aligned blocks do not pay off
+  constexpr Kernels AVX2_KERNELS = {
+    Level::AVX2,
+    &memeq_kernel<V256>, &mismatch_kernel<V256>, &strlen_kernel<V128>, &streq_kernel<V128>,
+    &find_byte_kernel<V256>, &find_any_of_kernel<V256>, &find_substring_kernel<V256>,
+  };
+
+  Level detect_level() noexcept {
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    const bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0
+      && (_xgetbv(0) & 0x6) == 0x6;
+
+    bool avx2 = false;
+    if (max_leaf >= 7) {
+      __cpuidex(info, 7, 0);
+      avx2 = (info[1] & (1 << 5)) != 0;
+    }
+
+    // SSE2 is part of x64
+    return (os_saves_avx && avx2) ? Level::AVX2 : Level::SSE2;
+  }
+
+  const Kernels* kernels_for(Level level) noexcept {
+    switch (level) {
+      case Level::Scalar: return &SCALAR_KERNELS;
+      case Level::SSE2: return &SSE2_KERNELS;
+      case Level::AVX2: return &AVX2_KERNELS;
+    }
+
+    INVALID_CODE_PATH("Invalid simd level");
+  }
+
+  // Null until the first call, every thread resolves it to the same table
+  std::atomic<const Kernels*> active_kernels = nullptr;
+
+  const Kernels* kernels() noexcept {
+    const Kernels* k = active_kernels.load(std::memory_order_relaxed);
+    if (k == nullptr) {
+      k = kernels_for(detected_level());
+      active_kernels.store(k, std::memory_order_relaxed);
+    }
+    return k;
+  }
+}
+
+Level detected_level() noexcept {
+  static const Level level = detect_level();
+  return level;
+}
+
+Level active_level() noexcept {
+  return kernels()->level;
+}
+
+void set_level(Level level) noexcept {
+  const Level max = detected_level();
+  if (static_cast<u8>(level) > static_cast<u8>(max)) {
+    level = max;
+  }
+
+  active_kernels.store(kernels_for(level), std::memory_order_relaxed);
+}
+
+bool memeq(const u8* a, const u8* b, usize len) noexcept {
+  return kernels()->memeq(a, b, len);
+}
+
+usize mismatch(const u8* a, const u8* b, usize len) noexcept {
+  return kernels()->mismatch(a, b, len);
+}
+
+usize strlen(const char* str) noexcept {
+  return kernels()->strlen(str);
+}
+
+bool streq(const char* a, const char* b) noexcept {
+  return kernels()->streq(a, b);
+}
+
+const u8* find_byte(const u8* data, usize len, u8 byte) noexcept {
+  return kernels()->find_byte(data, len, byte);
+}
+
+const u8* find_any_of(const u8* data, usize len, const u8* set, usize set_len) noexcept {
+  return kernels()->find_any_of(data, len, set, set_len);
+}
+
+const u8* find_substring(const u8* data, usize len, const u8* sub, usize sub_len) noexcept {
+  return kernels()->find_substring(data, len, sub, sub_len);
+}
+}
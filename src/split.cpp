@@ -0,0 +1,130 @@
+#include <AxleUtil/split.h>
+#include <AxleUtil/safe_lib.h>
+
+namespace Axle {
+  static ViewArr<const char> strip_cr(const ViewArr<const char>& line) {
+    if (line.size > 0 && line.data[line.size - 1] == '\r') {
+      return { line.data, line.size - 1 };
+    }
+    return line;
+  }
+
+  bool LineSplitter::next(ViewArr<const char>& line) {
+    if (rest.size == 0) return false;
+
+    const char* end = find_byte(rest, '\n');
+    if (end == nullptr) {
+      line = strip_cr(rest);
+      rest = {};
+      return true;
+    }
+
+    const usize len = static_cast<usize>(end - rest.data);
+    line = strip_cr({ rest.data, len });
+    rest = view_arr(rest, len + 1, rest.size - (len + 1));
+    return true;
+  }
+
+  bool FieldSplitter::next(ViewArr<const char>& field) {
+    if (finished) return false;
+
+    last_quoted = false;
+    last_delimiter = '\0';
+    ViewArr<const char> search = rest;
+
+    if (quote != '\0' && rest.size > 0 && rest.data[0] == quote) {
+      last_quoted = true;
+
+      // Find the closing quote, skipping doubled ones
+      usize i = 1;
+      while (true) {
+        const char* q = find_byte(view_arr(rest, i, rest.size - i), quote);
+        if (q == nullptr) {
+          // Unterminated, take everything
+          field = view_arr(rest, 1, rest.size - 1);
+          rest = {};
+          finished = true;
+          return true;
+        }
+
+        const usize q_index = static_cast<usize>(q - rest.data);
+        if (q_index + 1 < rest.size && rest.data[q_index + 1] == quote) {
+          i = q_index + 2;
+          continue;
+        }
+
+        field = view_arr(rest, 1, q_index - 1);
+        search = view_arr(rest, q_index + 1, rest.size - (q_index + 1));
+        break;
+      }
+    }
+
+    // Anything between a closing quote and the next delimiter is ignored
+    const char* delim = find_any_of(search, delimiters);
+    if (delim == nullptr) {
+      if (!last_quoted) field = rest;
+      rest = {};
+      finished = true;
+      return true;
+    }
+
+    const usize d_index = static_cast<usize>(delim - rest.data);
+    last_delimiter = *delim;
+    if (!last_quoted) {
+      field = { rest.data, d_index };
+      if (last_delimiter == '\n') field = strip_cr(field);
+    }
+
+    rest = view_arr(rest, d_index + 1, rest.size - (d_index + 1));
+    if (last_delimiter == '\n' && rest.size == 0) finished = true;
+    return true;
+  }
+
+  void LineStream::push(const ViewArr<const char>& data) {
+    ASSERT(chunk.size == 0);
+    chunk = data;
+  }
+
+  bool LineStream::next(ViewArr<const char>& line) {
+    if (carry_returned) {
+      carry.clear();
+      carry_returned = false;
+    }
+
+    if (chunk.size == 0) return false;
+
+    const char* end = find_byte(chunk, '\n');
+    if (end == nullptr) {
+      carry.concat(chunk);
+      chunk = {};
+      return false;
+    }
+
+    const usize len = static_cast<usize>(end - chunk.data);
+    if (carry.size > 0) {
+      carry.concat(view_arr(chunk, 0, len));
+      line = strip_cr(view_arr(carry));
+      carry_returned = true;
+    }
+    else {
+      line = strip_cr({ chunk.data, len });
+    }
+
+    chunk = view_arr(chunk, len + 1, chunk.size - (len + 1));
+    return true;
+  }
+
+  bool LineStream::finish(ViewArr<const char>& line) {
+    ASSERT(chunk.size == 0);
+    if (carry_returned) {
+      carry.clear();
+      carry_returned = false;
+    }
+
+    if (carry.size == 0) return false;
+
+    line = strip_cr(view_arr(carry));
+    carry_returned = true;
+    return true;
+  }
+}
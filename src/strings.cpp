@@ -1,39 +1,48 @@
 #include <AxleUtil/strings.h>
 #include <AxleUtil/safe_lib.h>
+#include <AxleUtil/files.h>
+#include <AxleUtil/serialize.h>
 #include <AxleUtil/tracing_wrapper.h>
 
 namespace Axle {
-Table::Table() : data(allocate_default<const InternString*>(8)), size(8) {}
+Table::Table() : data(allocate_default<Slot>(8)), size(8) {}
 
 
 Table::~Table() {
-  free_destruct_n<const InternString*>(data, size);
+  free_destruct_n<Slot>(data, size);
   data = nullptr;
   size = 0;
   num_full = 0;
 }
 
-const InternString** Table::find(const char* str, size_t len, uint64_t hash) const {
-  uint64_t test_index = hash % size;
+Table::Slot* Table::find(const char* str, size_t len, uint64_t hash) const {
+  const usize mask = size - 1;
+  const u32 hash_frag = hash_fragment(hash);
+  const u32 len_frag = static_cast<u32>(len);
 
-  const InternString** first_tombstone = nullptr;
+  usize test_index = hash & mask;
 
-  const InternString* el = data[test_index];
-  while (el != nullptr) {
+  Slot* first_tombstone = nullptr;
 
-    if (el == Intern::TOMBSTONE && first_tombstone == nullptr) {
+  const Slot* slot = data + test_index;
+  while (slot->string != nullptr) {
+
+    if (slot->string == Intern::TOMBSTONE) {
       //Tombstone space
-      first_tombstone =  data + test_index;
+      if (first_tombstone == nullptr) first_tombstone = data + test_index;
     }
-    else if (el->hash == hash && el->len == len && memeq_ts<char>(str, el->string, len)) {
-      //Success
-      return data + test_index;
+    else if (slot->hash_fragment == hash_frag && slot->len_fragment == len_frag) {
+      //Only now look at the string
+      const InternString* el = slot->string;
+      if (el->hash == hash && el->len == len && memeq_ts<char>(str, el->string, len)) {
+        //Success
+        return data + test_index;
+      }
     }
 
     //Try next one
-    test_index++;
-    test_index %= size;
-    el = data[test_index];
+    test_index = (test_index + 1) & mask;
+    slot = data + test_index;
   }
 
   //Test for tombstone
@@ -45,11 +54,12 @@ const InternString** Table::find(const char* str, size_t len, uint64_t hash) con
   }
 }
 
-const InternString** Table::find_empty(uint64_t hash) const {
-  uint64_t test_index = hash % size;
+Table::Slot* Table::find_empty(uint64_t hash) const {
+  const usize mask = size - 1;
+  usize test_index = hash & mask;
 
-  const InternString* el = data[test_index];
   while (true) {
+    const InternString* el = data[test_index].string;
 
     if (el == nullptr || el == Intern::TOMBSTONE) {
       //Empty space
@@ -57,36 +67,73 @@ const InternString** Table::find_empty(uint64_t hash) const {
     }
 
     //Try next one
-    test_index++;
-    test_index %= size;
-    el = data[test_index];
+    test_index = (test_index + 1) & mask;
   }
 }
 
+Hash::HashTableStats Table::stats() const {
+  Hash::HashTableStats s = {};
+  s.capacity = size;
+  s.used = num_full;
+
+  for (usize i = 0; i < size; ++i) {
+    const InternString* el = data[i].string;
+    if (el == nullptr) continue;
+
+    if (el == Intern::TOMBSTONE) {
+      s.tombstones += 1;
+    }
+    else {
+      s.add_probe(i, el->hash & (size - 1));
+    }
+  }
+
+#ifdef AXLE_HASH_STATS
+  s.resize_count = resize_stats.count;
+  s.resize_time_ns = resize_stats.time_ns;
+#endif
+
+  return s;
+}
+
+void Table::clear() {
+  free_destruct_n<Slot>(data, size);
+  data = allocate_default<Slot>(8);
+  size = 8;
+  num_full = 0;
+}
+
 void Table::try_resize() {
-  if (num_full >= static_cast<usize>(static_cast<float>(size) * LOAD_FACTOR)) {
+  reserve(0);
+}
+
+void Table::reserve(usize extra) {
+  const usize needed = num_full + extra;
+  if (needed >= static_cast<usize>(static_cast<float>(size) * LOAD_FACTOR)) {
+    AXLE_HASH_RESIZE_TIMER(resize_stats);
+
     const size_t old_size = size;
-    const InternString** const old_data = data;
+    Slot* const old_data = data;
 
     do {
       size <<= 1;
-    } while (num_full >= static_cast<usize>(static_cast<float>(size) * LOAD_FACTOR));
-    data = allocate_default<const InternString*>(size);
+    } while (needed >= static_cast<usize>(static_cast<float>(size) * LOAD_FACTOR));
+    data = allocate_default<Slot>(size);
 
     {
       auto i = old_data;
       const auto end = old_data + old_size;
       for (; i < end; i++) {
-        const InternString* i_str = *i;
+        const InternString* i_str = i->string;
 
         if (i_str != nullptr && i_str != Intern::TOMBSTONE) {
-          auto** place = find_empty(i_str->hash);
-          *place = i_str;
+          // Slots already hold everything needed to move them
+          *find_empty(i_str->hash) = *i;
         }
       }
     }
 
-    free_no_destruct<const InternString*>(old_data);
+    free_no_destruct<Slot>(old_data);
   }
 }
 
@@ -105,21 +152,104 @@ static void destroy_is_big(void* is) {
   free_destruct_n<u8>(reinterpret_cast<u8*>(is), original_size);
 }
 
+template<usize BLOCK_SIZE>
+static InternString* new_intern_string(GrowingMemoryPool<BLOCK_SIZE>& allocs,
+                                       const char* string, const size_t length, uint64_t hash) {
+  InternString* new_el;
+  char* string_data;
+
+  {
+    usize alloc_size = sizeof(InternString) + length + 1;
+    auto* dl = allocs.alloc_destruct_element();
+    if(allocs.is_big_alloc(alloc_size)) {
+      dl->deleter = &destroy_is_big;
+    }
+    else {
+      dl->deleter = &destroy_is;
+    }
+
+    void* mem = allocs.alloc_raw_no_delete(alloc_size, alignof(InternString));
+    mem = std::assume_aligned<alignof(InternString)>(mem);
+
+    new_el = new(mem) InternString();
+
+
+    string_data = new(reinterpret_cast<u8*>(mem) + sizeof(InternString)) char[length + 1];
+    new_el->string = string_data;
+
+    dl->data = new_el;
+  }
+
+  new_el->hash = hash;
+  new_el->len = length;
+
+  ASSERT(new_el->string == string_data);
+  memcpy_ts(string_data, length + 1, string, length);
+  string_data[length] = '\0';
+
+  return new_el;
+}
+
+const InternString* StringInterner::shared_empty_string() const {
+  const StringInterner* root = this;
+  while (root->parent != nullptr) {
+    root = root->parent;
+  }
+  return &root->empty_string;
+}
+
+const InternString* StringInterner::find_in_parents(const char* string, const size_t length, uint64_t hash) const {
+  for (const StringInterner* p = parent; p != nullptr; p = p->parent) {
+    const InternString* el = p->table.find(string, length, hash)->string;
+    if (el != nullptr && el != Intern::TOMBSTONE) {
+      return el;
+    }
+  }
+
+  return nullptr;
+}
+
+StringInterner::StringInterner(const StringInterner* parent_) : parent(parent_) {
+  if (parent != nullptr) {
+    parent->children.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+StringInterner::~StringInterner() {
+  ASSERT(children.load(std::memory_order_relaxed) == 0);
+  if (parent != nullptr) {
+    parent->children.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+void StringInterner::reset() {
+  ASSERT(!snapshot.is_mapped());
+  ASSERT(children.load(std::memory_order_relaxed) == 0);
+
+  table.clear();
+  allocs.free();
+}
+
 const InternString* StringInterner::find(const char* string, const size_t length) const {
   AXLE_UTIL_TELEMETRY_FUNCTION();
 
   if(string == nullptr || length == 0) {
     ASSERT(string == 0 && length == 0);
-    return &empty_string;
+    return shared_empty_string();
   }
 
   ASSERT(string != nullptr && length > 0);
 
   const uint64_t hash = fnv1a_hash(string, length);
 
-  const InternString** const place = table.find(string, length, hash);
+  if (parent != nullptr) {
+    const InternString* from_parent = find_in_parents(string, length, hash);
+    if (from_parent != nullptr) return from_parent;
+  }
+
+  const Table::Slot* const place = table.find(string, length, hash);
 
-  const InternString* el = *place;
+  const InternString* el = place->string;
   if (el == nullptr || el == Intern::TOMBSTONE) {
     return nullptr;
   }
@@ -128,62 +258,616 @@ const InternString* StringInterner::find(const char* string, const size_t length
   }
 }
 
+void StringInterner::find_batch(const ViewArr<const ViewArr<const char>>& strings, const ViewArr<const InternString*>& out) const {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+  ASSERT(strings.size == out.size);
+
+  uint64_t hashes[Hash::BATCH_PREFETCH_WINDOW];
+
+  for (usize base = 0; base < strings.size; base += Hash::BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(strings.size - base, Hash::BATCH_PREFETCH_WINDOW);
+
+    for (usize i = 0; i < count; ++i) {
+      const ViewArr<const char>& str = strings[base + i];
+      if (str.size == 0) continue;
+
+      hashes[i] = fnv1a_hash(str.data, str.size);
+      for (const StringInterner* p = this; p != nullptr; p = p->parent) {
+        p->table.prefetch(hashes[i]);
+      }
+    }
+
+    for (usize i = 0; i < count; ++i) {
+      const ViewArr<const char>& str = strings[base + i];
+      if(str.data == nullptr || str.size == 0) {
+        ASSERT(str.data == 0 && str.size == 0);
+        out[base + i] = shared_empty_string();
+        continue;
+      }
+
+      if (parent != nullptr) {
+        const InternString* from_parent = find_in_parents(str.data, str.size, hashes[i]);
+        if (from_parent != nullptr) {
+          out[base + i] = from_parent;
+          continue;
+        }
+      }
+
+      const InternString* el = table.find(str.data, str.size, hashes[i])->string;
+      if (el == nullptr || el == Intern::TOMBSTONE) {
+        out[base + i] = nullptr;
+      }
+      else {
+        out[base + i] = el;
+      }
+    }
+  }
+}
+
 const InternString* StringInterner::intern(const char* string, const size_t length) {
   AXLE_UTIL_TELEMETRY_FUNCTION();
   
   if(string == nullptr || length == 0) {
     ASSERT(string == 0 && length == 0);
-    return &empty_string;
+    return shared_empty_string();
   }
 
   ASSERT(string != nullptr && length > 0);
+  ASSERT(children.load(std::memory_order_relaxed) == 0);
 
   const uint64_t hash = fnv1a_hash(string, length);
 
-  const InternString** const place = table.find(string, length, hash);
+  if (parent != nullptr) {
+    const InternString* from_parent = find_in_parents(string, length, hash);
+    if (from_parent != nullptr) return from_parent;
+  }
+
+  Table::Slot* const place = table.find(string, length, hash);
 
-  const InternString* el = *place;
+  const InternString* el = place->string;
   if (el == nullptr || el == Intern::TOMBSTONE) {
-    InternString* new_el;
-    char* string_data;
-    
-    {
-      usize alloc_size = sizeof(InternString) + length + 1;
-      auto* dl = allocs.alloc_destruct_element();
-      if(allocs.is_big_alloc(alloc_size)) {
-        dl->deleter = &destroy_is_big;
+    InternString* new_el = new_intern_string(allocs, string, length, hash);
+
+    *place = Table::make_slot(new_el);
+
+    table.num_full++;
+    table.try_resize();
+    return new_el;
+  }
+  else {
+    return el;
+  }
+}
+
+void StringInterner::intern_batch(const ViewArr<const ViewArr<const char>>& strings, const ViewArr<const InternString*>& out) {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+  ASSERT(strings.size == out.size);
+  ASSERT(children.load(std::memory_order_relaxed) == 0);
+
+  OwnedArr<uint64_t> hashes = new_arr<uint64_t>(strings.size);
+
+  // Pass 1: hash and look everything up, out[i] == nullptr marks a string that needs adding
+  usize new_count = 0;
+  usize new_bytes = 0;
+  for (usize base = 0; base < strings.size; base += Hash::BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(strings.size - base, Hash::BATCH_PREFETCH_WINDOW);
+
+    for (usize i = base; i < base + count; ++i) {
+      const ViewArr<const char>& str = strings[i];
+      if (str.size == 0) continue;
+
+      hashes[i] = fnv1a_hash(str.data, str.size);
+      for (const StringInterner* p = this; p != nullptr; p = p->parent) {
+        p->table.prefetch(hashes[i]);
+      }
+    }
+
+    for (usize i = base; i < base + count; ++i) {
+      const ViewArr<const char>& str = strings[i];
+      if(str.data == nullptr || str.size == 0) {
+        ASSERT(str.data == 0 && str.size == 0);
+        out[i] = shared_empty_string();
+        continue;
+      }
+
+      if (parent != nullptr) {
+        const InternString* from_parent = find_in_parents(str.data, str.size, hashes[i]);
+        if (from_parent != nullptr) {
+          out[i] = from_parent;
+          continue;
+        }
+      }
+
+      const InternString* el = table.find(str.data, str.size, hashes[i])->string;
+      if (el == nullptr || el == Intern::TOMBSTONE) {
+        out[i] = nullptr;
+        new_count += 1;
+        new_bytes += ceil_to_N<alignof(InternString)>(sizeof(InternString) + str.size + 1);
       }
       else {
-        dl->deleter = &destroy_is;
+        out[i] = el;
+      }
+    }
+  }
+
+  if (new_count == 0) return;
+
+  // Duplicates inside the batch are counted more than once, so this is an upper bound
+  table.reserve(new_count);
+
+  u8* block = reinterpret_cast<u8*>(allocs.alloc_raw(new_bytes, alignof(InternString)));
+  block = std::assume_aligned<alignof(InternString)>(block);
+  usize block_top = 0;
+
+  // Pass 2: insert the misses, the table may have moved so prefetch again
+  for (usize base = 0; base < strings.size; base += Hash::BATCH_PREFETCH_WINDOW) {
+    const usize count = smaller<usize>(strings.size - base, Hash::BATCH_PREFETCH_WINDOW);
+
+    for (usize i = base; i < base + count; ++i) {
+      if (out[i] == nullptr) table.prefetch(hashes[i]);
+    }
+
+    for (usize i = base; i < base + count; ++i) {
+      if (out[i] != nullptr) continue;
+
+      const ViewArr<const char>& str = strings[i];
+      Table::Slot* const place = table.find(str.data, str.size, hashes[i]);
+
+      const InternString* el = place->string;
+      if (el != nullptr && el != Intern::TOMBSTONE) {
+        // Added earlier in this batch
+        out[i] = el;
+        continue;
       }
 
-      void* mem = allocs.alloc_raw_no_delete(alloc_size, alignof(InternString));
-      mem = std::assume_aligned<alignof(InternString)>(mem);
-      
-      new_el = new(mem) InternString();
+      u8* mem = block + block_top;
+      block_top += ceil_to_N<alignof(InternString)>(sizeof(InternString) + str.size + 1);
+      ASSERT(block_top <= new_bytes);
 
+      InternString* new_el = new(mem) InternString();
+      char* string_data = new(mem + sizeof(InternString)) char[str.size + 1];
+      memcpy_ts(string_data, str.size + 1, str.data, str.size);
+      string_data[str.size] = '\0';
 
-      string_data = new(reinterpret_cast<u8*>(mem) + sizeof(InternString)) char[length + 1];
+      new_el->hash = hashes[i];
+      new_el->len = str.size;
       new_el->string = string_data;
 
-      dl->data = new_el;
+      *place = Table::make_slot(new_el);
+      table.num_full++;
+
+      out[i] = new_el;
+    }
+  }
+
+  ASSERT(table.num_full < static_cast<usize>(static_cast<float>(table.size) * Table::LOAD_FACTOR));
+}
+
+CompactStringInterner::~CompactStringInterner() {
+  if (slots != nullptr) {
+    free_no_destruct<u32>(slots);
+  }
+  slots = nullptr;
+  slot_count = 0;
+}
+
+static u32* compact_find_slot(u32* slots, usize slot_count,
+                              const CompactStringInterner& interner,
+                              const ViewArr<const char>& str, u64 hash) {
+  const usize mask = slot_count - 1;
+  usize index = hash & mask;
+
+  while (true) {
+    const u32 id = slots[index];
+    if (id == CompactStringInterner::EMPTY_SLOT) return slots + index;
+
+    const CompactStringInterner::Entry& e = interner.entries.data[id];
+    if (e.hash == hash && e.len == str.size
+        && memeq_ts<char>(interner.bytes.data + e.offset, str.data, str.size)) {
+      return slots + index;
     }
 
-    new_el->hash = hash;
-    new_el->len = length;
-  
-    ASSERT(new_el->string == string_data);
-    memcpy_ts(string_data, length + 1, string, length);
-    string_data[length] = '\0';
-    
-    *place = new_el;
+    index = (index + 1) & mask;
+  }
+}
 
-    table.num_full++;
-    table.try_resize();
-    return new_el;
+InternId CompactStringInterner::find(const ViewArr<const char>& str) const {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+  if (slots == nullptr) return Intern::INVALID_ID;
+
+  const u64 hash = fnv1a_hash(str.data, str.size);
+  return { *compact_find_slot(slots, slot_count, *this, str, hash) };
+}
+
+InternId CompactStringInterner::intern(const ViewArr<const char>& str) {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+
+  if (entries.size + 1 >= static_cast<usize>(static_cast<float>(slot_count) * LOAD_FACTOR)) {
+    const usize new_count = slot_count == 0 ? 8 : slot_count << 1;
+    u32* const new_slots = allocate_default<u32>(new_count);
+    for (usize i = 0; i < new_count; ++i) {
+      new_slots[i] = EMPTY_SLOT;
+    }
+
+    // Hashes are kept in entries so nothing is rehashed
+    const usize mask = new_count - 1;
+    for (usize i = 0; i < entries.size; ++i) {
+      usize index = entries.data[i].hash & mask;
+      while (new_slots[index] != EMPTY_SLOT) {
+        index = (index + 1) & mask;
+      }
+      new_slots[index] = static_cast<u32>(i);
+    }
+
+    if (slots != nullptr) {
+      free_no_destruct<u32>(slots);
+    }
+    slots = new_slots;
+    slot_count = new_count;
+  }
+
+  const u64 hash = fnv1a_hash(str.data, str.size);
+  u32* const place = compact_find_slot(slots, slot_count, *this, str, hash);
+  if (*place != EMPTY_SLOT) return { *place };
+
+  ASSERT(entries.size < static_cast<usize>(Intern::TOMBSTONE_ID.id));
+  ASSERT(bytes.size + str.size <= static_cast<usize>(0xFFFFFFFF));
+
+  const u32 id = static_cast<u32>(entries.size);
+  entries.insert(Entry{ static_cast<u32>(bytes.size), static_cast<u32>(str.size), hash });
+
+  // str is allowed to be a view into bytes
+  const char* src = str.data;
+  if (bytes.data <= src && src < bytes.data + bytes.size) {
+    const usize offset = static_cast<usize>(src - bytes.data);
+    bytes.reserve_extra(str.size);
+    src = bytes.data + offset;
+  }
+  bytes.concat(src, str.size);
+
+  *place = id;
+  return { id };
+}
+
+Hash::HashTableStats CompactStringInterner::stats() const {
+  Hash::HashTableStats s = {};
+  s.capacity = slot_count;
+  s.used = entries.size;
+
+  for (usize i = 0; i < slot_count; ++i) {
+    const u32 id = slots[i];
+    if (id == EMPTY_SLOT) continue;
+
+    s.add_probe(i, entries.data[id].hash & (slot_count - 1));
+  }
+
+  return s;
+}
+
+namespace {
+  // Snapshot layout, every offset is from the start of the file:
+  // header | records[string_count] | u32 slots[table_size] | string bytes
+  // Records are laid out exactly like InternString but with the string pointer stored as an offset
+  // Slots store record index + 1, so 0 is still empty (there are never tombstones)
+  constexpr u32 SNAPSHOT_MAGIC = 0x53495841;// "AXIS"
+  constexpr u32 SNAPSHOT_VERSION = 1;
+
+  struct SnapshotHeader {
+    u32 magic;
+    u32 version;
+    u64 string_count;
+    u64 table_size;
+    u64 records_offset;
+    u64 slots_offset;
+    u64 strings_offset;
+    u64 total_size;
+  };
+
+  static_assert(sizeof(InternString) == 3 * sizeof(u64));
+  static_assert(offsetof(InternString, hash) == 0);
+  static_assert(offsetof(InternString, len) == sizeof(u64));
+  static_assert(offsetof(InternString, string) == 2 * sizeof(u64));
+}
+
+FILES::ErrorCode StringInterner::save_snapshot(const ViewArr<const char>& file_name) const {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+
+  usize string_bytes = 0;
+  for (usize i = 0; i < table.size; ++i) {
+    const InternString* el = table.data[i].string;
+    if (el == nullptr || el == Intern::TOMBSTONE) continue;
+
+    string_bytes += el->len + 1;
+  }
+
+  SnapshotHeader h = {};
+  h.magic = SNAPSHOT_MAGIC;
+  h.version = SNAPSHOT_VERSION;
+  h.string_count = table.num_full;
+  h.table_size = table.size;
+  h.records_offset = sizeof(SnapshotHeader);
+  h.slots_offset = h.records_offset + h.string_count * sizeof(InternString);
+  h.strings_offset = h.slots_offset + h.table_size * sizeof(u32);
+  h.total_size = h.strings_offset + string_bytes;
+
+  Array<u8> bytes = {};
+  bytes.reserve_total(h.total_size);
+
+  {
+    Serializer<Array<u8>, ByteOrder::LittleEndian> ser(bytes);
+    serialize_le(ser, h.magic);
+    serialize_le(ser, h.version);
+    serialize_le(ser, h.string_count);
+    serialize_le(ser, h.table_size);
+    serialize_le(ser, h.records_offset);
+    serialize_le(ser, h.slots_offset);
+    serialize_le(ser, h.strings_offset);
+    serialize_le(ser, h.total_size);
+    ASSERT(bytes.size == h.records_offset);
+
+    u64 string_offset = h.strings_offset;
+    for (usize i = 0; i < table.size; ++i) {
+      const InternString* el = table.data[i].string;
+      if (el == nullptr || el == Intern::TOMBSTONE) continue;
+
+      serialize_le(ser, static_cast<u64>(el->hash));
+      serialize_le(ser, static_cast<u64>(el->len));
+      serialize_le(ser, string_offset);
+      string_offset += el->len + 1;
+    }
+    ASSERT(bytes.size == h.slots_offset);
+
+    // Records were written in slot order
+    u32 record = 1;
+    for (usize i = 0; i < table.size; ++i) {
+      const InternString* el = table.data[i].string;
+      if (el == nullptr) {
+        serialize_le(ser, static_cast<u32>(0));
+      }
+      else {
+        ASSERT(el != Intern::TOMBSTONE);
+        serialize_le(ser, record);
+        record += 1;
+      }
+    }
+    ASSERT(bytes.size == h.strings_offset);
+
+    for (usize i = 0; i < table.size; ++i) {
+      const InternString* el = table.data[i].string;
+      if (el == nullptr || el == Intern::TOMBSTONE) continue;
+
+      ser.write_bytes(ViewArr<const u8>{ reinterpret_cast<const u8*>(el->string), el->len });
+      serialize_le(ser, static_cast<u8>('\0'));
+    }
+    ASSERT(bytes.size == h.total_size);
+  }
+
+  FILES::OpenedFile file = FILES::replace(file_name, FILES::OPEN_MODE::WRITE);
+  if (file.error_code != FILES::ErrorCode::OK) return file.error_code;
+
+  return FILES::write(file.file, bytes.data, bytes.size);
+}
+
+FILES::ErrorCode StringInterner::load_snapshot(const ViewArr<const char>& file_name) {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+  ASSERT(table.num_full == 0);
+  ASSERT(children.load(std::memory_order_relaxed) == 0);
+
+  // Copy on write so the records can be fixed up in place
+  FILES::MappedFile mapped = {};
+  const FILES::ErrorCode err = FILES::map_file(mapped, file_name, FILES::MAP_MODE::COPY_ON_WRITE);
+  if (err != FILES::ErrorCode::OK) return err;
+
+  if (mapped.size < sizeof(SnapshotHeader)) return FILES::ErrorCode::INVALID_FILE_FORMAT;
+
+  const SnapshotHeader* h = reinterpret_cast<const SnapshotHeader*>(mapped.data);
+  if (h->magic != SNAPSHOT_MAGIC || h->version != SNAPSHOT_VERSION
+      || h->total_size != mapped.size
+      || h->table_size < 8 || (h->table_size & (h->table_size - 1)) != 0
+      || h->string_count >= h->table_size
+      || h->records_offset != sizeof(SnapshotHeader)
+      || h->slots_offset != h->records_offset + h->string_count * sizeof(InternString)
+      || h->strings_offset != h->slots_offset + h->table_size * sizeof(u32)
+      || h->strings_offset > h->total_size) {
+    return FILES::ErrorCode::INVALID_FILE_FORMAT;
+  }
+
+  InternString* records = reinterpret_cast<InternString*>(mapped.data + h->records_offset);
+  const u32* slots = reinterpret_cast<const u32*>(mapped.data + h->slots_offset);
+
+  for (usize i = 0; i < h->string_count; ++i) {
+    InternString& r = records[i];
+    const u64 offset = reinterpret_cast<uintptr_t>(r.string);
+    if (offset < h->strings_offset || offset >= h->total_size
+        || r.len == 0 || r.len >= h->total_size - offset
+        || mapped.data[offset + r.len] != '\0') {
+      return FILES::ErrorCode::INVALID_FILE_FORMAT;
+    }
+
+    r.string = reinterpret_cast<const char*>(mapped.data + offset);
+  }
+
+  // Each record must sit in exactly one slot, reachable by probing from its hash
+  // The interner never leaves tombstones, and string_count < table_size keeps an empty slot to end every probe
+  const usize mask = h->table_size - 1;
+  OwnedArr<bool> placed = new_arr<bool>(h->string_count);
+  usize num_placed = 0;
+  for (usize i = 0; i < h->table_size; ++i) {
+    const u32 s = slots[i];
+    if (s == 0) continue;
+    if (s > h->string_count || placed[s - 1]) return FILES::ErrorCode::INVALID_FILE_FORMAT;
+    placed[s - 1] = true;
+    num_placed += 1;
+
+    for (usize j = records[s - 1].hash & mask; j != i; j = (j + 1) & mask) {
+      if (slots[j] == 0) return FILES::ErrorCode::INVALID_FILE_FORMAT;
+    }
+  }
+  if (num_placed != h->string_count) return FILES::ErrorCode::INVALID_FILE_FORMAT;
+
+  Table::Slot* const data = allocate_default<Table::Slot>(h->table_size);
+  for (usize i = 0; i < h->table_size; ++i) {
+    const u32 s = slots[i];
+    if (s != 0) data[i] = Table::make_slot(records + (s - 1));
+  }
+
+  free_destruct_n<Table::Slot>(table.data, table.size);
+  table.data = data;
+  table.size = h->table_size;
+  table.num_full = h->string_count;
+
+  snapshot = std::move(mapped);
+  return FILES::ErrorCode::OK;
+}
+
+using ShardTable = ConcurrentStringInterner::ShardTable;
+
+static ShardTable* new_shard_table(usize size) {
+  ShardTable* t = allocate_default<ShardTable>();
+  t->data = allocate_default<std::atomic<const InternString*>>(size);
+  t->size = size;
+  return t;
+}
+
+static const InternString* shard_table_find(const ShardTable* t, const char* string, size_t length, uint64_t hash) {
+  const usize mask = t->size - 1;
+  usize index = hash & mask;
+
+  while (true) {
+    const InternString* el = t->data[index].load(std::memory_order_acquire);
+    if (el == nullptr) return nullptr;
+
+    if (el->hash == hash && el->len == length && memeq_ts<char>(string, el->string, length)) {
+      return el;
+    }
+
+    index = (index + 1) & mask;
+  }
+}
+
+static void shard_table_insert(ShardTable* t, const InternString* str) {
+  const usize mask = t->size - 1;
+  usize index = str->hash & mask;
+
+  while (t->data[index].load(std::memory_order_relaxed) != nullptr) {
+    index = (index + 1) & mask;
+  }
+
+  t->data[index].store(str, std::memory_order_release);
+}
+
+ConcurrentStringInterner::~ConcurrentStringInterner() {
+  for (Shard& shard : shards) {
+    ShardTable* t = shard.table.exchange(nullptr);
+    while (t != nullptr) {
+      ShardTable* retired = t->retired;
+      free_destruct_n<std::atomic<const InternString*>>(t->data, t->size);
+      free_destruct_single<ShardTable>(t);
+      t = retired;
+    }
+  }
+}
+
+const InternString* ConcurrentStringInterner::find(const char* string, const size_t length) const {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+
+  if(string == nullptr || length == 0) {
+    ASSERT(string == 0 && length == 0);
+    return &empty_string;
+  }
+
+  const uint64_t hash = fnv1a_hash(string, length);
+  const ShardTable* t = shards[shard_index(hash)].table.load(std::memory_order_acquire);
+  if (t == nullptr) return nullptr;
+
+  return shard_table_find(t, string, length, hash);
+}
+
+const InternString* ConcurrentStringInterner::intern(const char* string, const size_t length) {
+  AXLE_UTIL_TELEMETRY_FUNCTION();
+
+  if(string == nullptr || length == 0) {
+    ASSERT(string == 0 && length == 0);
+    return &empty_string;
+  }
+
+  const uint64_t hash = fnv1a_hash(string, length);
+  Shard& shard = shards[shard_index(hash)];
+
+  {
+    const ShardTable* t = shard.table.load(std::memory_order_acquire);
+    if (t != nullptr) {
+      const InternString* el = shard_table_find(t, string, length, hash);
+      if (el != nullptr) return el;
+    }
+  }
+
+  shard.mutex.acquire();
+  DEFER(&) { shard.mutex.release(); };
+
+  // Only this thread can change the table now, but it might have changed before we got the lock
+  ShardTable* t = shard.table.load(std::memory_order_acquire);
+  if (t == nullptr) {
+    t = new_shard_table(8);
+    shard.table.store(t, std::memory_order_release);
   }
   else {
-    return el;
+    const InternString* el = shard_table_find(t, string, length, hash);
+    if (el != nullptr) return el;
+  }
+
+  InternString* new_el = new_intern_string(shard.allocs, string, length, hash);
+  shard.num_full += 1;
+
+  if (shard.num_full >= static_cast<usize>(static_cast<float>(t->size) * Table::LOAD_FACTOR)) {
+    // Readers may still be probing the old table so it is kept until the interner is destroyed
+    ShardTable* new_t = new_shard_table(t->size << 1);
+    new_t->retired = t;
+
+    for (usize i = 0; i < t->size; ++i) {
+      const InternString* el = t->data[i].load(std::memory_order_relaxed);
+      if (el != nullptr) {
+        shard_table_insert(new_t, el);
+      }
+    }
+
+    shard_table_insert(new_t, new_el);
+    shard.table.store(new_t, std::memory_order_release);
+  }
+  else {
+    shard_table_insert(t, new_el);
+  }
+
+  return new_el;
+}
+
+Hash::HashTableStats ConcurrentStringInterner::stats() const {
+  Hash::HashTableStats s = {};
+
+  for (const Shard& shard : shards) {
+    const ShardTable* t = shard.table.load(std::memory_order_acquire);
+    if (t == nullptr) continue;
+
+    Hash::HashTableStats shard_stats = {};
+    shard_stats.capacity = t->size;
+
+    for (usize i = 0; i < t->size; ++i) {
+      const InternString* el = t->data[i].load(std::memory_order_acquire);
+      if (el == nullptr) continue;
+
+      shard_stats.used += 1;
+      shard_stats.add_probe(i, el->hash & (t->size - 1));
+    }
+
+    s.capacity += shard_stats.capacity;
+    s.used += shard_stats.used;
+    s.probe_total += shard_stats.probe_total;
+    s.probe_max = larger(s.probe_max, shard_stats.probe_max);
+    for (usize i = 0; i < Hash::HashTableStats::PROBE_HISTOGRAM_SIZE; ++i) {
+      s.probe_histogram[i] += shard_stats.probe_histogram[i];
+    }
   }
+
+  return s;
 }
 }
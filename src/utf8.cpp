@@ -0,0 +1,278 @@
+#include <AxleUtil/utf8.h>
+#include <AxleUtil/simd.h>
+
+#include <intrin.h>
+#include <immintrin.h>
+
+#include <bit>
+
+namespace Axle {
+namespace {
+  // Validates from a code point boundary until p is at least end
+  bool validate_scalar_past(const u8*& p, const u8* end, const u8* data_end) noexcept {
+    while (p < end) {
+      const UTF8Decode d = utf8_decode(reinterpret_cast<const char*>(p), static_cast<usize>(data_end - p));
+      if (d.length == 0) return false;
+      p += d.length;
+    }
+    return true;
+  }
+
+  // Skips whole blocks of ascii and validates everything else one code point at a time
+  bool validate_sse2(const u8* data, usize len) noexcept {
+    const u8* p = data;
+    const u8* const end = data + len;
+
+    while (static_cast<usize>(end - p) >= 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+      const u32 high = static_cast<u32>(_mm_movemask_epi8(block));
+      if (high == 0) {
+        p += 16;
+        continue;
+      }
+
+      // Ascii before the first high byte is already known to be fine
+      const u8* const block_end = p + 16;
+      p += std::countr_zero(high);
+      if (!validate_scalar_past(p, block_end, end)) return false;
+    }
+
+    return validate_scalar_past(p, end, end);
+  }
+
+  // Lookup table validation from "Validating UTF-8 In Less Than One Instruction Per Byte"
+  // (Keiser and Lemire). Each byte is checked against the 3 before it using 3 nibble lookups,
+  // so there is no branching on the content of non-ascii blocks
+  namespace AVX2 {
+    constexpr u8 TOO_SHORT = 1 << 0;
+    constexpr u8 TOO_LONG = 1 << 1;
+    constexpr u8 OVERLONG_3 = 1 << 2;
+    constexpr u8 TOO_LARGE = 1 << 3;
+    constexpr u8 SURROGATE = 1 << 4;
+    constexpr u8 OVERLONG_2 = 1 << 5;
+    constexpr u8 TOO_LARGE_1000 = 1 << 6;
+    constexpr u8 OVERLONG_4 = 1 << 6;
+    constexpr u8 TWO_CONTS = 1 << 7;
+    constexpr u8 CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    __m256i table(u8 t0, u8 t1, u8 t2, u8 t3, u8 t4, u8 t5, u8 t6, u8 t7,
+                  u8 t8, u8 t9, u8 t10, u8 t11, u8 t12, u8 t13, u8 t14, u8 t15) noexcept {
+      return _mm256_setr_epi8(
+        static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+        static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+        static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+        static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15),
+        static_cast<char>(t0), static_cast<char>(t1), static_cast<char>(t2), static_cast<char>(t3),
+        static_cast<char>(t4), static_cast<char>(t5), static_cast<char>(t6), static_cast<char>(t7),
+        static_cast<char>(t8), static_cast<char>(t9), static_cast<char>(t10), static_cast<char>(t11),
+        static_cast<char>(t12), static_cast<char>(t13), static_cast<char>(t14), static_cast<char>(t15));
+    }
+
+    __m256i high_nibbles(__m256i v) noexcept {
+      return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+    }
+
+    // Bytes of input shifted along by N, pulling the last N bytes of prev in at the front
+    template<int N>
+    __m256i prev(__m256i input, __m256i prev_input) noexcept {
+      return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+    }
+
+    struct State {
+      __m256i error = _mm256_setzero_si256();
+      __m256i prev_input = _mm256_setzero_si256();
+      __m256i prev_incomplete = _mm256_setzero_si256();
+    };
+
+    void check_block(State& s, __m256i input) noexcept {
+      if (_mm256_movemask_epi8(input) == 0) {
+        // Ascii can only be wrong if the last block ended partway through a sequence
+        s.error = _mm256_or_si256(s.error, s.prev_incomplete);
+        s.prev_incomplete = _mm256_setzero_si256();
+        s.prev_input = input;
+        return;
+      }
+
+      const __m256i prev1 = prev<1>(input, s.prev_input);
+
+      const __m256i byte_1_high = _mm256_shuffle_epi8(table(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+      ), high_nibbles(prev1));
+
+      const __m256i byte_1_low = _mm256_shuffle_epi8(table(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000
+      ), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+
+      const __m256i byte_2_high = _mm256_shuffle_epi8(table(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+      ), high_nibbles(input));
+
+      const __m256i special_cases = _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+
+      // 3rd and 4th bytes of a sequence must be continuations, which special_cases flags as TWO_CONTS
+      const __m256i is_third = _mm256_subs_epu8(prev<2>(input, s.prev_input), _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+      const __m256i is_fourth = _mm256_subs_epu8(prev<3>(input, s.prev_input), _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+      const __m256i must_be_cont = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+
+      s.error = _mm256_or_si256(s.error, _mm256_xor_si256(must_be_cont, special_cases));
+
+      // Any lead byte in the last 3 positions that needs more bytes than are left
+      const __m256i max_value = _mm256_setr_epi8(
+        -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1,
+        static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1));
+      s.prev_incomplete = _mm256_subs_epu8(input, max_value);
+      s.prev_input = input;
+    }
+
+    bool validate(const u8* data, usize len) noexcept {
+      State s = {};
+
+      usize i = 0;
+      for (; i + 32 <= len; i += 32) {
+        check_block(s, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+      }
+
+      if (i < len) {
+        // Zero padding is ascii, so a sequence cut off by the end is caught as too short
+        alignas(32) u8 tail[32] = {};
+        for (usize j = 0; i + j < len; ++j) {
+          tail[j] = data[i + j];
+        }
+        check_block(s, _mm256_load_si256(reinterpret_cast<const __m256i*>(tail)));
+      }
+
+      const __m256i error = _mm256_or_si256(s.error, s.prev_incomplete);
+      return _mm256_testz_si256(error, error) != 0;
+    }
+  }
+
+  // Appends the ascii prefix of in to out 16 bytes at a time, returns how many bytes were done
+  usize widen_ascii(const u8* in, usize len, Array<char16_t>& out) {
+    if (SIMD::active_level() == SIMD::Level::Scalar) return 0;
+
+    usize i = 0;
+    for (; i + 16 <= len; i += 16) {
+      const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+      if (_mm_movemask_epi8(block) != 0) break;
+
+      out.reserve_extra(16);
+      __m128i* dst = reinterpret_cast<__m128i*>(out.data + out.size);
+      const __m128i zero = _mm_setzero_si128();
+      _mm_storeu_si128(dst, _mm_unpacklo_epi8(block, zero));
+      _mm_storeu_si128(dst + 1, _mm_unpackhi_epi8(block, zero));
+      out.size += 16;
+    }
+    return i;
+  }
+}
+
+bool utf8_validate_runtime(const ViewArr<const char>& str) noexcept {
+  const u8* data = reinterpret_cast<const u8*>(str.data);
+
+  switch (SIMD::active_level()) {
+    case SIMD::Level::Scalar: return utf8_validate_scalar(str);
+    case SIMD::Level::SSE2: return validate_sse2(data, str.size);
+    case SIMD::Level::AVX2: return AVX2::validate(data, str.size);
+  }
+
+  INVALID_CODE_PATH("Invalid simd level");
+}
+
+bool utf8_to_utf16(const ViewArr<const char>& in, Array<char16_t>& out) {
+  // Never more utf-16 units than utf-8 bytes
+  out.reserve_extra(in.size);
+
+  bool valid = true;
+  usize i = 0;
+  while (i < in.size) {
+    i += widen_ascii(reinterpret_cast<const u8*>(in.data + i), in.size - i, out);
+
+    // Either the end or at least one non-ascii byte in the next 16
+    const usize block_end = smaller<usize>(in.size, i + 16);
+    while (i < block_end) {
+      u32 code_point;
+      const UTF8Decode d = utf8_decode(in.data + i, in.size - i);
+      if (d.length == 0) {
+        valid = false;
+        code_point = UNICODE_REPLACEMENT_CHARACTER;
+        i += 1;
+      }
+      else {
+        code_point = d.code_point;
+        i += d.length;
+      }
+
+      if (code_point >= 0x10000) {
+        const u32 v = code_point - 0x10000;
+        out.insert(static_cast<char16_t>(0xD800 | (v >> 10)));
+        out.insert(static_cast<char16_t>(0xDC00 | (v & 0x3FF)));
+      }
+      else {
+        out.insert(static_cast<char16_t>(code_point));
+      }
+    }
+  }
+
+  return valid;
+}
+
+bool utf16_to_utf8(const ViewArr<const char16_t>& in, Array<char>& out) {
+  out.reserve_extra(in.size);
+
+  bool valid = true;
+  usize i = 0;
+  while (i < in.size) {
+    u32 code_point = in.data[i];
+    i += 1;
+
+    if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+      if (code_point <= 0xDBFF && i < in.size && in.data[i] >= 0xDC00 && in.data[i] <= 0xDFFF) {
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (in.data[i] - 0xDC00u);
+        i += 1;
+      }
+      else {
+        // Unpaired surrogate
+        valid = false;
+        code_point = UNICODE_REPLACEMENT_CHARACTER;
+      }
+    }
+
+    char buffer[4];
+    const u32 n = utf8_encode(code_point, buffer);
+    ASSERT(n > 0);
+    out.concat(buffer, n);
+  }
+
+  return valid;
+}
+}
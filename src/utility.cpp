@@ -24,6 +24,9 @@ void Panic::set_panic_callback(const void* data, CallbackFn callback) noexcept {
 }
 
 void Panic::default_panic_callback(const void*, const ViewArr<const char>& message) noexcept {
+  // Anything this thread buffered came before the panic
+  IO::flush();
+
   IO_Single::ScopeLock lock;
   Format::STErrPrintFormatter formatter = {};
   formatter.load_string(message.data, message.size);
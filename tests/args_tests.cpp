@@ -1,4 +1,6 @@
 #include <AxleUtil/args.h>
+#include <AxleUtil/files.h>
+#include <AxleUtil/format.h>
 
 #include <AxleTest/unit_tests.h>
 
@@ -85,3 +87,131 @@ TEST_FUNCTION(Args, fail) {
   TEST_EQ(false, res1);
   TEST_EQ(static_cast<char>('b'), c);
 }
+
+TEST_FUNCTION(Args, numbers) {
+  const char* args[] {
+    "executable.exe",
+    "-count=42",
+    "-offset=-0x10",
+    "-scale=0.5",
+    "-small=300",
+  };
+  const auto arg_list = clArg::ArgsList{ Axle::array_size(args), args };
+
+  Axle::u32 count = 0;
+  Axle::i64 offset = 0;
+  double scale = 0;
+  TEST_EQ(true, clArg::parse_arg(*test_errors, arg_list, Axle::lit_view_arr("count"), count));
+  TEST_EQ(true, clArg::parse_arg(*test_errors, arg_list, Axle::lit_view_arr("offset"), offset));
+  TEST_EQ(true, clArg::parse_arg(*test_errors, arg_list, Axle::lit_view_arr("scale"), scale));
+  if(test_errors->is_panic()) return;
+
+  TEST_EQ(static_cast<Axle::u32>(42), count);
+  TEST_EQ(static_cast<Axle::i64>(-16), offset);
+  TEST_EQ(0.5, scale);
+
+  ShouldFail errors = {};
+  Axle::u8 small = 1;
+  TEST_EQ(false, clArg::parse_arg(errors, arg_list, Axle::lit_view_arr("small"), small));
+  TEST_EQ(true, errors.failed);
+  TEST_EQ(static_cast<Axle::u8>(1), small);
+}
+
+TEST_FUNCTION(Args, index) {
+  // Enough arguments that scanning per option would be noticeable
+  constexpr usize NUM_DEFINES = 10000;
+  Axle::Array<char> storage = {};
+  Axle::Array<usize> starts = {};
+  for (usize i = 0; i < NUM_DEFINES; ++i) {
+    const Axle::OwnedArr<char> define = Axle::format("-define=D{}", i);
+    starts.insert(storage.size);
+    storage.concat(define.data, define.size);
+    storage.insert('\0');
+  }
+
+  Axle::Array<const char*> args = {};
+  args.insert("executable.exe");
+  args.insert("-count=42");
+  for (usize i = 0; i < NUM_DEFINES; ++i) {
+    args.insert(storage.data + starts[i]);
+    if (i == NUM_DEFINES / 2) args.insert("-count=7");
+  }
+  args.insert("-flag");
+  args.insert("positional");
+
+  clArg::ArgsIndex index = {};
+  TEST_EQ(true, clArg::build_index(*test_errors, clArg::ArgsList{ args.size, args.data }, index));
+  if(test_errors->is_panic()) return;
+
+  const auto values = index.get(Axle::lit_view_arr("define"));
+  TEST_EQ(NUM_DEFINES, values.size);
+  for (usize i = 0; i < values.size; ++i) {
+    const Axle::OwnedArr<const char> expected = Axle::format("D{}", i);
+    TEST_STR_EQ(expected, values[i]);
+  }
+
+  // Repeated options keep their order and the first one that parses wins
+  const auto counts = index.get(Axle::lit_view_arr("count"));
+  TEST_EQ(static_cast<usize>(2), counts.size);
+  TEST_STR_EQ(Axle::lit_view_arr("7"), counts[1]);
+
+  Axle::u32 count = 0;
+  TEST_EQ(true, clArg::parse_arg(*test_errors, index, Axle::lit_view_arr("count"), count));
+  if(test_errors->is_panic()) return;
+  TEST_EQ(static_cast<Axle::u32>(42), count);
+
+  TEST_EQ(static_cast<usize>(0), index.get(Axle::lit_view_arr("flag")).size);
+
+  ShouldFail errors = {};
+  char c = 'b';
+  TEST_EQ(false, clArg::parse_arg(errors, index, Axle::lit_view_arr("missing"), c));
+  TEST_EQ(true, errors.failed);
+}
+
+TEST_FUNCTION(Args, response_file) {
+  {
+    Axle::FILES::OpenedFile outer = Axle::FILES::replace(Axle::lit_view_arr("./args_outer.rsp"), Axle::FILES::OPEN_MODE::WRITE);
+    TEST_EQ(Axle::FILES::ErrorCode::OK, outer.error_code);
+    TEST_EQ(Axle::FILES::ErrorCode::OK, Axle::FILES::write_str(outer.file, "-name=outer\r\n@./args_inner.rsp  \"-path=with space\"\n-define=\"A B\" -name=last"));
+
+    Axle::FILES::OpenedFile inner = Axle::FILES::replace(Axle::lit_view_arr("./args_inner.rsp"), Axle::FILES::OPEN_MODE::WRITE);
+    TEST_EQ(Axle::FILES::ErrorCode::OK, inner.error_code);
+    TEST_EQ(Axle::FILES::ErrorCode::OK, Axle::FILES::write_str(inner.file, "\t-name=inner\n"));
+  }
+
+  const char* args[] {
+    "executable.exe",
+    "-name=first",
+    "@./args_outer.rsp",
+  };
+
+  clArg::ArgsIndex index = {};
+  TEST_EQ(true, clArg::build_index(*test_errors, clArg::ArgsList{ Axle::array_size(args), args }, index));
+  if(test_errors->is_panic()) return;
+
+  const auto names = index.get(Axle::lit_view_arr("name"));
+  TEST_EQ(static_cast<usize>(4), names.size);
+  TEST_STR_EQ(Axle::lit_view_arr("first"), names[0]);
+  TEST_STR_EQ(Axle::lit_view_arr("outer"), names[1]);
+  TEST_STR_EQ(Axle::lit_view_arr("inner"), names[2]);
+  TEST_STR_EQ(Axle::lit_view_arr("last"), names[3]);
+
+  const auto paths = index.get(Axle::lit_view_arr("path"));
+  TEST_EQ(static_cast<usize>(1), paths.size);
+  TEST_STR_EQ(Axle::lit_view_arr("with space"), paths[0]);
+
+  // Quotes part way through a token are stripped too
+  const auto defines = index.get(Axle::lit_view_arr("define"));
+  TEST_EQ(static_cast<usize>(1), defines.size);
+  TEST_STR_EQ(Axle::lit_view_arr("A B"), defines[0]);
+
+  const char* missing[] {
+    "executable.exe",
+    "@./args_missing.rsp",
+  };
+
+  ShouldFail errors = {};
+  clArg::ArgsIndex missing_index = {};
+  TEST_EQ(false, clArg::build_index(errors, clArg::ArgsList{ Axle::array_size(missing), missing }, missing_index));
+  TEST_EQ(true, errors.failed);
+}
@@ -0,0 +1,186 @@
+#include <AxleUtil/async_log.h>
+#include <AxleUtil/threading.h>
+#include <AxleUtil/split.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  struct CaptureSink {
+    std::atomic<bool> stall = false;
+    Array<char> out = {};// only touched by the drain thread until it is stopped
+  };
+
+  void capture(const ViewArr<const char>& batch, void* data) {
+    CaptureSink* sink = static_cast<CaptureSink*>(data);
+    while (sink->stall.load()) {}
+    sink->out.concat(batch);
+  }
+
+  // Reads "DEBUG | <a> <b>"
+  bool parse_line(const ViewArr<const char>& line, usize& a, usize& b) {
+    const auto prefix = lit_view_arr("DEBUG | ");
+    if (line.size < prefix.size) return false;
+
+    usize* nums[2] = { &a, &b };
+    usize n = 0;
+    a = 0;
+    b = 0;
+    for (usize i = prefix.size; i < line.size; ++i) {
+      const char c = line[i];
+      if (c == ' ') {
+        n += 1;
+        if (n == 2) return false;
+      }
+      else if (c >= '0' && c <= '9') {
+        *nums[n] = *nums[n] * 10 + static_cast<usize>(c - '0');
+      }
+      else {
+        return false;
+      }
+    }
+    return n == 1;
+  }
+
+  constexpr usize NUM_THREADS = 4;
+  constexpr usize NUM_LINES = 2000;
+
+  struct LogThread {
+    usize index;
+  };
+
+  void write_file(const ViewArr<const char>& batch, void* data) {
+    std::fwrite(batch.data, 1, batch.size, static_cast<FILE*>(data));
+  }
+
+  void log_thread(const ThreadHandle*, LogThread* data) {
+    for (usize i = 0; i < NUM_LINES; ++i) {
+      LOG::debug("{} {}", data->index, i);
+    }
+  }
+}
+
+TEST_FUNCTION(AsyncLog, threads_keep_order) {
+  CaptureSink sink = {};
+
+  // Small rings so they wrap and fill up plenty
+  LOG::start_async({ .ring_size = 1024, .policy = LOG::AsyncPolicy::Block, .sink = capture, .sink_data = &sink });
+  TEST_EQ(true, LOG::is_async());
+
+  LogThread data[NUM_THREADS];
+  const ThreadHandle* handles[NUM_THREADS];
+  for (usize i = 0; i < NUM_THREADS; ++i) {
+    data[i] = { i };
+    handles[i] = start_thread<log_thread>(data + i);
+  }
+
+  for (usize i = 0; i < NUM_THREADS; ++i) {
+    wait_for_thread_end(handles[i]);
+  }
+
+  LOG::stop_async();
+  TEST_EQ(false, LOG::is_async());
+  TEST_EQ(static_cast<u64>(0), LOG::dropped_count());
+
+  usize next[NUM_THREADS] = {};
+  LineSplitter lines = { const_view_arr(sink.out) };
+  ViewArr<const char> line;
+  while (lines.next(line)) {
+    usize t, i;
+    TEST_EQ(true, parse_line(line, t, i));
+    TEST_EQ(true, t < NUM_THREADS);
+    TEST_EQ(next[t], i);
+    next[t] += 1;
+  }
+
+  for (usize t = 0; t < NUM_THREADS; ++t) {
+    TEST_EQ(NUM_LINES, next[t]);
+  }
+}
+
+TEST_FUNCTION(AsyncLog, drop_when_full) {
+  CaptureSink sink = {};
+  sink.stall.store(true);
+
+  // The drain thread gets stuck in the sink after its first pass, so most of these have nowhere to go
+  LOG::start_async({ .ring_size = 1024, .policy = LOG::AsyncPolicy::Drop, .sink = capture, .sink_data = &sink });
+  for (usize i = 0; i < NUM_LINES; ++i) {
+    LOG::debug("0 {}", i);
+  }
+
+  const u64 dropped = LOG::dropped_count();
+  TEST_EQ(true, dropped > 0);
+
+  sink.stall.store(false);
+  LOG::stop_async();
+
+  usize count = 0;
+  usize last = 0;
+  LineSplitter lines = { const_view_arr(sink.out) };
+  ViewArr<const char> line;
+  while (lines.next(line)) {
+    usize t, i;
+    TEST_EQ(true, parse_line(line, t, i));
+    TEST_EQ(true, count == 0 || i > last);
+    last = i;
+    count += 1;
+  }
+
+  TEST_EQ(NUM_LINES, count + dropped);
+}
+
+TEST_FUNCTION(AsyncLog, oversized_keeps_order) {
+  // The sink and this thread's synchronous writes share one file, so it shows the order they came out in
+  FILE* file = std::tmpfile();
+  TEST_EQ(true, file != nullptr);
+  IO::set_output(IO::Stream::Err, file);
+
+  constexpr usize SMALL_COUNT = 5;
+  Array<char> big = {};
+  for (usize i = 0; i < 1000; ++i) {
+    big.insert('b');
+  }
+
+  // Long idle sleeps so the small records are still in the ring when the big one is logged
+  LOG::start_async({ .ring_size = 256, .policy = LOG::AsyncPolicy::Block, .idle_sleep_ms = 100, .sink = write_file, .sink_data = file });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+  for (usize i = 0; i < SMALL_COUNT; ++i) {
+    LOG::debug("0 {}", i);
+  }
+  // Too big for half of any ring this thread already has, so it is written synchronously
+  LOG::debug("{}", view_arr(big));
+  LOG::debug("0 {}", SMALL_COUNT);
+  LOG::stop_async();
+
+  IO::flush();
+  IO::set_output(IO::Stream::Err, stderr);
+
+  std::fflush(file);
+  Array<char> out = {};
+  out.insert_uninit(static_cast<usize>(std::ftell(file)));
+  std::rewind(file);
+  TEST_EQ(out.size, std::fread(out.data, 1, out.size, file));
+  std::fclose(file);
+
+  usize count = 0;
+  LineSplitter lines = { const_view_arr(out) };
+  ViewArr<const char> line;
+  while (lines.next(line)) {
+    if (count == SMALL_COUNT) {
+      TEST_STR_EQ(view_arr(big), view_arr(line, 8, line.size - 8));
+    }
+    else {
+      usize t, i;
+      TEST_EQ(true, parse_line(line, t, i));
+      TEST_EQ(count < SMALL_COUNT ? count : count - 1, i);
+    }
+    count += 1;
+  }
+  TEST_EQ(SMALL_COUNT + 2, count);
+}
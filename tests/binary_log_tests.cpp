@@ -0,0 +1,104 @@
+#include <AxleUtil/binary_log.h>
+#include <AxleUtil/io.h>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  void capture(const ViewArr<const u8>& bytes, void* data) {
+    static_cast<Array<u8>*>(data)->concat(bytes.data, bytes.size);
+  }
+
+  // With a flush size of 1 the sink is called once per entry
+  struct EntrySink {
+    Array<u8> bytes = {};
+    Array<usize> ends = {};
+  };
+
+  void capture_entries(const ViewArr<const u8>& bytes, void* data) {
+    EntrySink* sink = static_cast<EntrySink*>(data);
+    sink->bytes.concat(bytes.data, bytes.size);
+    sink->ends.insert(sink->bytes.size);
+  }
+
+  // Both calls below use this exact array, as if the compiler had pooled two identical literals
+  constexpr char SHARED_FORMAT[] = "value {}";
+}
+
+TEST_FUNCTION(BinaryLog, round_trip) {
+  EntrySink sink = {};
+  const Array<u8>& bytes = sink.bytes;
+
+  {
+    LOG::BinaryLog log = { capture_entries, &sink, 1 };
+    LOG::set_binary_log(&log);
+
+    for (int i = 0; i < 3; ++i) {
+      LOG::debug("count {} of {}, {{literal}}", i, 3u);
+    }
+    LOG::warn("{} {} {} {}", true, 'c', -12345678901ll, lit_view_arr("view"));
+    LOG::error("float {} double {} array {}", 1.5f, 0.25, "abc");
+    // Not binary loggable, so it gets formatted as it is written
+    LOG::debug("hex {}", Format::Hex<u32>{ 0xbeef });
+
+    LOG::set_binary_log(nullptr);
+  }
+
+  Array<char> text = {};
+  TEST_EQ(true, LOG::decode_binary_log(const_view_arr(bytes), text));
+
+  const auto expected = lit_view_arr(
+    "DEBUG | count 0 of 3, {literal}\n"
+    "DEBUG | count 1 of 3, {literal}\n"
+    "DEBUG | count 2 of 3, {literal}\n"
+    "WARN  | true c -12345678901 view\n"
+    "ERROR | float 1.5 double 0.25 array abc\n"
+    "DEBUG | hex 0x0000BEEF\n");
+  TEST_STR_EQ(expected, view_arr(text));
+
+  // Cutting the log anywhere but between two entries must fail rather than read past the end
+  constexpr usize HEADER_SIZE = array_size(LOG::BINARY_LOG_MAGIC) + 1;
+  usize next_end = 0;
+  for (usize len = 0; len < bytes.size; ++len) {
+    while (sink.ends[next_end] < len) next_end += 1;
+    const bool whole_entries = len == HEADER_SIZE || sink.ends[next_end] == len;
+
+    Array<char> partial = {};
+    TEST_EQ(whole_entries, LOG::decode_binary_log({ bytes.data, len }, partial));
+  }
+}
+
+TEST_FUNCTION(BinaryLog, same_format_different_types) {
+  Array<u8> bytes = {};
+
+  {
+    LOG::BinaryLog log = { capture, &bytes };
+    log.write(LOG::Level::Debug, SHARED_FORMAT, 7u);
+    log.write(LOG::Level::Debug, SHARED_FORMAT, lit_view_arr("seven"));
+    log.write(LOG::Level::Debug, SHARED_FORMAT, 8u);
+  }
+
+  Array<char> text = {};
+  TEST_EQ(true, LOG::decode_binary_log(const_view_arr(bytes), text));
+  TEST_STR_EQ(lit_view_arr("DEBUG | value 7\nDEBUG | value seven\nDEBUG | value 8\n"), view_arr(text));
+}
+
+TEST_FUNCTION(BinaryLog, format_written_once) {
+  Array<u8> bytes = {};
+  LOG::BinaryLog log = { capture, &bytes };
+
+  usize sizes[4] = {};
+  for (usize i = 0; i < array_size(sizes); ++i) {
+    log.write(LOG::Level::Debug, "value {}", static_cast<u32>(i));
+    sizes[i] = log.bytes.size;
+  }
+
+  // After the first call only the record itself is written
+  for (usize i = 1; i < array_size(sizes); ++i) {
+    TEST_EQ(static_cast<usize>(1 + 1 + 4 + 4), sizes[i] - sizes[i - 1]);
+  }
+
+  log.flush();
+  TEST_EQ(sizes[array_size(sizes) - 1], bytes.size);
+  TEST_EQ(static_cast<usize>(0), log.bytes.size);
+}
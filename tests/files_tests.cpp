@@ -207,6 +207,140 @@ TEST_FUNCTION(Files, open_read) {
   }
 }
 
+TEST_FUNCTION(Files, map_file) {
+  {
+    FILES::MappedFile mapped = {};
+    FILES::ErrorCode error = FILES::map_file(mapped, data_file_path, FILES::MAP_MODE::READ_ONLY);
+    TEST_EQ(FILES::ErrorCode::OK, error);
+    TEST_EQ(true, mapped.is_mapped());
+
+    TEST_STR_EQ(full_test_file, cast_arr<const char>(mapped.view()));
+  }
+
+  {
+    FILES::MappedFile mapped = {};
+    FILES::ErrorCode error = FILES::map_file(mapped, data_file_path, FILES::MAP_MODE::COPY_ON_WRITE);
+    TEST_EQ(FILES::ErrorCode::OK, error);
+
+    mapped.data[0] = 'J';
+    TEST_EQ(static_cast<u8>('J'), mapped.data[0]);
+  }
+
+  // Copy on write pages never reach the file
+  OwnedArr<const u8> data = FILES::read_full_file(data_file_path);
+  TEST_STR_EQ(full_test_file, cast_arr<const char>(view_arr(data)));
+
+  {
+    FILES::MappedFile mapped = {};
+    FILES::ErrorCode error = FILES::map_file(mapped, "./tests/data2.txt"_litview, FILES::MAP_MODE::READ_ONLY);
+    TEST_NEQ(FILES::ErrorCode::OK, error);
+    TEST_EQ(false, mapped.is_mapped());
+  }
+}
+
+TEST_FUNCTION(Files, buffered_format_write) {
+  constexpr auto out_path = "./buffered_format.txt"_litview;
+  const ViewArr<const char> long_str = "a string that is longer than the whole buffer"_litview;
+
+  {
+    FILES::OpenedFile file = FILES::replace(out_path, FILES::OPEN_MODE::WRITE);
+    TEST_EQ(FILES::ErrorCode::OK, file.error_code);
+
+    // Small buffer so that both flushing and writing straight through happen
+    FILES::BufferedFileFormatter buffered = { file.file, 16 };
+    for (u32 i = 0; i < 20; ++i) {
+      Format::format_to(buffered, "{} ", i);
+    }
+    Format::format_to(buffered, "{}\n", long_str);
+    TEST_EQ(FILES::ErrorCode::OK, buffered.flush());
+
+    const u32 ids[] = { 1, 22, 333 };
+    const ViewArr<const char> names[] = { "one"_litview, "two"_litview, "three"_litview };
+    TEST_EQ(FILES::ErrorCode::OK,
+            FILES::format_write_many(file.file, "{}={}\n", ViewArr<const u32>{ ids, 3 }, ViewArr<const ViewArr<const char>>{ names, 3 }));
+
+    TEST_EQ(FILES::ErrorCode::OK, FILES::format_write(file.file, "{}|{}", long_str, long_str));
+    TEST_EQ(FILES::ErrorCode::OK, FILES::format_write(file.file, "|{}", 4u));
+  }
+
+  const OwnedArr<const char> expected = format("0 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 {}\n1=one\n22=two\n333=three\n{}|{}|4",
+                                               long_str, long_str, long_str);
+
+  OwnedArr<const u8> data = FILES::read_full_file(out_path);
+  TEST_STR_EQ(expected, cast_arr<const char>(view_arr(data)));
+}
+
+TEST_FUNCTION(Files, buffer_options) {
+  constexpr auto out_path = "./buffer_options.bin"_litview;
+  constexpr usize FILE_SIZE = 100000;
+
+  Array<u8> expected = {};
+  expected.insert_uninit(FILE_SIZE);
+  for (usize i = 0; i < FILE_SIZE; ++i) {
+    expected[i] = static_cast<u8>((i * 7) ^ (i >> 8));
+  }
+
+  {
+    // Too small so it gets clamped, then writes both smaller and larger than the buffer
+    FILES::OpenedFile file = FILES::replace(out_path, FILES::OPEN_MODE::WRITE, { 1, true });
+    TEST_EQ(FILES::ErrorCode::OK, file.error_code);
+    TEST_EQ(static_cast<u32>(FILES::BufferOptions::MIN_SIZE), file.file.data->buffer_capacity);
+
+    usize written = 0;
+    usize step = 1;
+    while (written < FILE_SIZE - 1000) {
+      const usize size = smaller(step, FILE_SIZE - 1000 - written);
+      TEST_EQ(FILES::ErrorCode::OK, FILES::write(file.file, expected.data + written, size));
+      written += size;
+      step = (step * 3) % 9001 + 1;
+    }
+
+    // Sequential writes grow the buffer
+    TEST_EQ(true, file.file.data->buffer_capacity > FILES::BufferOptions::MIN_SIZE);
+
+    TEST_EQ(FILES::ErrorCode::OK, FILES::write_padding_bytes(file.file, 0, 1000));
+
+    // Overwrite parts that are no longer buffered, including the padding
+    FILES::seek_from_start(file.file, 10);
+    TEST_EQ(FILES::ErrorCode::OK, FILES::write(file.file, expected.data + 10, 5));
+    FILES::seek_from_start(file.file, FILE_SIZE - 1000);
+    TEST_EQ(FILES::ErrorCode::OK, FILES::write(file.file, expected.data + FILE_SIZE - 1000, 1000));
+    TEST_EQ(FILE_SIZE, FILES::size_of_file(file.file));
+  }
+
+  {
+    OwnedArr<const u8> data = FILES::read_full_file(out_path);
+    TEST_EQ(FILE_SIZE, data.size);
+    TEST_EQ(true, memeq_ts<u8>(expected.data, data.data, FILE_SIZE));
+  }
+
+  for (const bool adaptive : { false, true }) {
+    FILES::OpenedFile file = FILES::open(out_path, FILES::OPEN_MODE::READ, { 64 * 1024, adaptive });
+    TEST_EQ(FILES::ErrorCode::OK, file.error_code);
+
+    Array<u8> bytes = {};
+    bytes.insert_uninit(FILE_SIZE);
+
+    usize read = 0;
+    usize step = 1;
+    while (read < FILE_SIZE) {
+      const usize size = smaller(step, FILE_SIZE - read);
+      TEST_EQ(FILES::ErrorCode::OK, FILES::read_to_bytes(file.file, bytes.data + read, size));
+      read += size;
+      step = (step * 5) % 70001 + 1;
+    }
+    TEST_EQ(true, memeq_ts<u8>(expected.data, bytes.data, FILE_SIZE));
+    TEST_EQ(adaptive, file.file.data->buffer_capacity > 64 * 1024);
+
+    // Jumping back is not sequential, so an adaptive buffer starts again from its base size
+    FILES::seek_from_start(file.file, 3);
+    u8 small[4] = {};
+    TEST_EQ(FILES::ErrorCode::OK, FILES::read_to_bytes(file.file, small, array_size(small)));
+    TEST_EQ(true, memeq_ts<u8>(expected.data + 3, small, array_size(small)));
+    TEST_EQ(static_cast<u32>(64 * 1024), file.file.data->buffer_capacity);
+  }
+}
+
 TEST_FUNCTION(Files, DirItr) {
   const FILES::DirectoryIteratorEnd end = {};
   FILES::DirectoryIterator itr = FILES::directory_iterator("./tests/data/"_litview);
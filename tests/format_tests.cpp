@@ -1,6 +1,8 @@
 #include <AxleUtil/format.h>
 
 #include <AxleTest/unit_tests.h>
+
+#include <charconv>
 using namespace Axle;
 using namespace Axle::Literals;
 
@@ -11,6 +13,44 @@ TEST_FUNCTION(Formatters, syntax) {
   TEST_STR_EQ(expected, arr);
 }
 
+TEST_FUNCTION(Formatters, segments) {
+  // Literal runs are found when the format string is checked
+  constexpr Format::FormatString<int, int> fmt = "a{}bc{{{}}}";
+  static_assert(fmt.segments[0].offset == 0 && fmt.segments[0].len == 1 && !fmt.segments[0].escaped);
+  static_assert(fmt.segments[1].offset == 3 && fmt.segments[1].len == 4 && fmt.segments[1].escaped);
+  static_assert(fmt.segments[2].offset == 9 && fmt.segments[2].len == 2 && fmt.segments[2].escaped);
+
+  OwnedArr<const char> arr = format(fmt, 1, 2);
+  TEST_STR_EQ("a1bc{2}"_litview, arr);
+
+  arr = format("{}{}", 1, 2);
+  TEST_STR_EQ("12"_litview, arr);
+
+  arr = format("{{}}{{");
+  TEST_STR_EQ("{}{"_litview, arr);
+
+  arr = format("");
+  TEST_STR_EQ(""_litview, arr);
+}
+
+TEST_FUNCTION(Formatters, MeasureFormatter) {
+  constexpr usize short_size = Format::formatted_size<u32, ViewArr<const char>>("{} {{}} {}", 1234u, "abc"_litview);
+  static_assert(short_size == 11);
+
+  const ViewArr<const char> long_str = "a string long enough to not fit in the local buffer of an ArrayFormatter"_litview;
+  const usize long_size = Format::formatted_size("[{}] {}: {}", 18446744073709551615ull, long_str, -12);
+  TEST_EQ(long_str.size + 28, long_size);
+
+  // format allocates exactly the measured size
+  OwnedArr<const char> arr = format("[{}] {}: {}", 18446744073709551615ull, long_str, -12);
+  TEST_EQ(long_size, arr.size);
+  TEST_EQ('[', arr[0]);
+  TEST_EQ('2', arr[arr.size - 1]);
+
+  arr = format("");
+  TEST_EQ(static_cast<usize>(0), arr.size);
+}
+
 TEST_FUNCTION(FormatArg, strings) {
   const ViewArr<const char> expected = "hello world"_litview;
   OwnedArr<const char> arr = format("hello {}", "world"_litview);
@@ -279,6 +319,36 @@ TEST_FUNCTION(FormatArg, HexInt) {
   }
 }
 
+TEST_FUNCTION(FormatArg, ints_match_to_chars) {
+  // Every digit count, and both sides of each power of 10
+  u64 v = 1;
+  while (true) {
+    const u64 values[] = { v - 1, v, v + 1, v * 9 / 5 };
+    for (u64 u : values) {
+      char expected[32];
+      const std::to_chars_result r = std::to_chars(expected, expected + 32, u);
+
+      OwnedArr<const char> actual = format("{}", u);
+      TEST_STR_EQ(ViewArr<const char>(expected, static_cast<usize>(r.ptr - expected)), actual);
+
+      OwnedArr<const char> hex = format("{}", Format::Hex<u64>{u});
+      const std::to_chars_result hr = std::to_chars(expected, expected + 32, u, 16);
+      const usize hex_len = static_cast<usize>(hr.ptr - expected);
+      TEST_EQ(static_cast<usize>(18), hex.size);
+      for (usize i = 0; i < hex_len; ++i) {
+        const char c = expected[i];
+        TEST_EQ((c >= 'a' && c <= 'f') ? static_cast<char>(c - 'a' + 'A') : c, hex[18 - hex_len + i]);
+      }
+    }
+
+    if (v > UINT64_MAX / 10) break;
+    v *= 10;
+  }
+
+  OwnedArr<const char> max = format("{}", UINT64_MAX);
+  TEST_STR_EQ("18446744073709551615"_litview, max);
+}
+
 TEST_FUNCTION(FormatArg, Floats) {
   {
     float f = 0.0f;
@@ -1,6 +1,10 @@
 #include <AxleUtil/strings.h>
+#include <AxleUtil/static_hash.h>
+#include <AxleUtil/frozen_hash.h>
 #include <AxleUtil/stdext/compare.h>
 
+#include <cstddef>
+
 #include <AxleTest/unit_tests.h>
 using namespace Axle;
 
@@ -638,6 +642,159 @@ TEST_FUNCTION(Hash, InternString_HashTable_Multiple) {
   }
 }
 
+TEST_FUNCTION(Hash, InternString_HashTable_Batch) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 40;
+  const InternString* strs[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    strs[i] = interner.format_intern("str{}", i);
+  }
+
+  InternHashTable<usize> table = {};
+  table.insert(strs[0], 100);
+  table.insert(strs[1], 101);
+
+  {
+    usize* found[3] = {};
+    const InternString* keys[3] = { strs[0], strs[1], strs[2] };
+    table.get_val_batch(view_arr(keys), view_arr(found));
+
+    TEST_NEQ(static_cast<usize*>(nullptr), found[0]);
+    TEST_EQ(static_cast<usize>(100), *found[0]);
+    TEST_NEQ(static_cast<usize*>(nullptr), found[1]);
+    TEST_EQ(static_cast<usize>(101), *found[1]);
+    TEST_EQ(static_cast<usize*>(nullptr), found[2]);
+  }
+
+  {
+    usize* created[COUNT] = {};
+    table.get_or_create_batch(view_arr(strs), view_arr(created));
+
+    TEST_EQ(COUNT, table.used);
+    for (usize i = 0; i < COUNT; ++i) {
+      TEST_NEQ(static_cast<usize*>(nullptr), created[i]);
+      TEST_EQ(table.get_val(strs[i]), created[i]);
+      *created[i] = i;
+    }
+
+    TEST_EQ(static_cast<usize>(0), *table.get_val(strs[0]));
+    TEST_EQ(static_cast<usize>(1), *table.get_val(strs[1]));
+  }
+
+  {
+    // Duplicates in the batch resolve to the same value
+    usize* created[4] = {};
+    const InternString* keys[4] = { strs[5], strs[5], strs[6], strs[5] };
+    table.get_or_create_batch(view_arr(keys), view_arr(created));
+
+    TEST_EQ(COUNT, table.used);
+    TEST_EQ(created[0], created[1]);
+    TEST_EQ(created[0], created[3]);
+    TEST_EQ(static_cast<usize>(5), *created[0]);
+    TEST_EQ(static_cast<usize>(6), *created[2]);
+  }
+}
+
+TEST_FUNCTION(Hash, InternString_HashSet_Batch) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 40;
+  const InternString* strs[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    strs[i] = interner.format_intern("str{}", i);
+  }
+
+  InternStringSet set = {};
+
+  {
+    bool found[COUNT] = {};
+    set.contains_batch(view_arr(strs), view_arr(found));
+    for (usize i = 0; i < COUNT; ++i) {
+      TEST_EQ(false, found[i]);
+    }
+  }
+
+  set.insert(strs[3]);
+  set.insert_batch(view_arr(strs, 0, COUNT / 2));
+  TEST_EQ(COUNT / 2, set.used);
+
+  {
+    bool found[COUNT] = {};
+    set.contains_batch(view_arr(strs), view_arr(found));
+    for (usize i = 0; i < COUNT; ++i) {
+      TEST_EQ(i < COUNT / 2, found[i]);
+    }
+  }
+}
+
+TEST_FUNCTION(Hash, Stats) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 20;
+  const InternString* strs[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    strs[i] = interner.format_intern("str{}", i);
+  }
+
+  {
+    InternHashTable<usize> table = {};
+
+    const Hash::HashTableStats empty = table.stats();
+    TEST_EQ(static_cast<usize>(0), empty.capacity);
+    TEST_EQ(static_cast<usize>(0), empty.used);
+    TEST_EQ(static_cast<usize>(0), empty.probe_max);
+
+    for (usize i = 0; i < COUNT; ++i) {
+      table.insert(strs[i], usize{ i });
+    }
+    table.remove(strs[0]);
+    table.remove(strs[1]);
+
+    const Hash::HashTableStats stats = table.stats();
+    TEST_EQ(table.el_capacity, stats.capacity);
+    TEST_EQ(COUNT - 2, stats.used);
+    TEST_EQ(static_cast<usize>(2), stats.tombstones);
+
+    usize histogram_total = 0;
+    for (usize h : stats.probe_histogram) {
+      histogram_total += h;
+    }
+    TEST_EQ(stats.used, histogram_total);
+    TEST_EQ(true, stats.probe_max >= 1);
+    TEST_EQ(true, stats.probe_total >= stats.used);
+    TEST_EQ(true, stats.load_factor() < InternHashTable<usize>::LOAD_FACTOR);
+
+    Format::ArrayFormatter formatter = {};
+    Format::format_to(formatter, "{}", stats);
+
+    const auto prefix = lit_view_arr("capacity: ");
+    const ViewArr<const char> out = formatter.view();
+    TEST_EQ(true, out.size > prefix.size);
+    TEST_STR_EQ(prefix, view_arr(out, 0, prefix.size));
+  }
+
+  {
+    InternStringSet set = {};
+    for (usize i = 0; i < COUNT; ++i) {
+      set.insert(strs[i]);
+    }
+    set.remove(strs[3]);
+
+    const Hash::HashTableStats stats = set.stats();
+    TEST_EQ(set.el_capacity, stats.capacity);
+    TEST_EQ(COUNT - 1, stats.used);
+    TEST_EQ(static_cast<usize>(1), stats.tombstones);
+  }
+
+  {
+    const Hash::HashTableStats stats = interner.table.stats();
+    TEST_EQ(interner.table.size, stats.capacity);
+    TEST_EQ(COUNT, stats.used);
+    TEST_EQ(static_cast<usize>(0), stats.tombstones);
+  }
+}
+
 namespace {
   struct FakeKey {
     u64 i;
@@ -868,3 +1025,264 @@ TEST_FUNCTION(Hash, HashTable_move) {
 
   TEST_EQ(static_cast<u64>(1), counter);
 }
+
+namespace {
+  enum struct Keyword : u8 {
+    If, Else, While, For, Return, Struct, Enum, Break, Continue, Switch,
+  };
+
+  constexpr auto KEYWORDS = Hash::make_static_hash_map<ViewArr<const char>, Keyword>({
+    { lit_view_arr("if"), Keyword::If },
+    { lit_view_arr("else"), Keyword::Else },
+    { lit_view_arr("while"), Keyword::While },
+    { lit_view_arr("for"), Keyword::For },
+    { lit_view_arr("return"), Keyword::Return },
+    { lit_view_arr("struct"), Keyword::Struct },
+    { lit_view_arr("enum"), Keyword::Enum },
+    { lit_view_arr("break"), Keyword::Break },
+    { lit_view_arr("continue"), Keyword::Continue },
+    { lit_view_arr("switch"), Keyword::Switch },
+  });
+
+  static_assert(KEYWORDS.contains(lit_view_arr("while")));
+  static_assert(*KEYWORDS.get_val(lit_view_arr("continue")) == Keyword::Continue);
+  static_assert(!KEYWORDS.contains(lit_view_arr("whilst")));
+}
+
+TEST_FUNCTION(Hash, StaticHashMap_strings) {
+  const ViewArr<const char> names[] = {
+    lit_view_arr("if"), lit_view_arr("else"), lit_view_arr("while"),
+    lit_view_arr("for"), lit_view_arr("return"), lit_view_arr("struct"),
+    lit_view_arr("enum"), lit_view_arr("break"), lit_view_arr("continue"),
+    lit_view_arr("switch"),
+  };
+
+  TEST_EQ(array_size(names), KEYWORDS.size());
+
+  for (usize i = 0; i < array_size(names); ++i) {
+    // Different pointer to the same characters
+    const OwnedArr<char> copy = copy_arr(names[i].data, names[i].size);
+
+    const Keyword* k = KEYWORDS.get_val(view_arr(copy));
+    TEST_NEQ(static_cast<const Keyword*>(nullptr), k);
+    TEST_EQ(static_cast<u8>(i), static_cast<u8>(*k));
+  }
+
+  TEST_EQ(static_cast<const Keyword*>(nullptr), KEYWORDS.get_val(lit_view_arr("")));
+  TEST_EQ(static_cast<const Keyword*>(nullptr), KEYWORDS.get_val(lit_view_arr("i")));
+  TEST_EQ(static_cast<const Keyword*>(nullptr), KEYWORDS.get_val(lit_view_arr("iff")));
+  TEST_EQ(static_cast<const Keyword*>(nullptr), KEYWORDS.get_val(lit_view_arr("Return")));
+}
+
+TEST_FUNCTION(Hash, StaticHashMap_integers) {
+  constexpr auto squares = Hash::make_static_hash_map<u32, u32>({
+    { 1, 1 }, { 2, 4 }, { 3, 9 }, { 4, 16 }, { 5, 25 }, { 6, 36 }, { 7, 49 },
+    { 100, 10000 }, { 1000, 1000000 },
+  });
+
+  static_assert(squares.NUM_SLOTS >= 9);
+
+  TEST_EQ(static_cast<u32>(49), *squares.get_val(7));
+  TEST_EQ(static_cast<u32>(10000), *squares.get_val(100));
+  TEST_EQ(static_cast<u32>(1000000), *squares.get_val(1000));
+  TEST_EQ(false, squares.contains(0));
+  TEST_EQ(false, squares.contains(8));
+
+  constexpr auto single = Hash::make_static_hash_map<u64, char>({ { 42, 'a' } });
+  TEST_EQ('a', *single.get_val(42));
+  TEST_EQ(false, single.contains(41));
+}
+
+TEST_FUNCTION(Hash, DenseHashTable_insertion_order) {
+  KeyGenerator gen = {};
+
+  constexpr usize COUNT = 50;
+  FakeKey keys[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    keys[i] = gen();
+  }
+
+  Hash::DenseHashTable<FakeKey, usize, FakeKeyTrait> table = {};
+  for (usize i = 0; i < COUNT; ++i) {
+    table.insert(keys[i], usize{ i });
+  }
+  TEST_EQ(COUNT, table.used);
+
+  // Overwrite does not change the order
+  table.insert(keys[10], usize{ 1000 });
+  TEST_EQ(COUNT, table.used);
+
+  usize i = 0;
+  for (auto it = table.itr(); it.is_valid(); it.next()) {
+    TEST_EQ(keys[i].i, it.key().i);
+    TEST_EQ(i == 10 ? static_cast<usize>(1000) : i, *it.val());
+    i += 1;
+  }
+  TEST_EQ(COUNT, i);
+
+  // Iterating through a const table only hands out const values
+  const auto& const_table = table;
+  static_assert(std::is_same_v<const usize*, decltype(const_table.itr().val())>);
+  static_assert(std::is_same_v<usize*, decltype(table.itr().val())>);
+  static_assert(std::is_same_v<ViewArr<const usize>, decltype(const_table.value_view())>);
+  i = 0;
+  for (auto it = const_table.itr(); it.is_valid(); it.next()) {
+    TEST_EQ(i == 10 ? static_cast<usize>(1000) : i, *it.val());
+    i += 1;
+  }
+  TEST_EQ(COUNT, i);
+
+  for (usize j = 0; j < COUNT; ++j) {
+    TEST_EQ(true, table.contains(keys[j]));
+  }
+  TEST_EQ(false, table.contains(gen()));
+  TEST_EQ(static_cast<usize*>(nullptr), table.get_val(gen()));
+}
+
+TEST_FUNCTION(Hash, DenseHashTable_remove) {
+  KeyGenerator gen = {};
+
+  const FakeKey k0 = gen();
+  const FakeKey k1 = gen();
+  const FakeKey k2 = gen();
+  const FakeKey k3 = gen();
+
+  Hash::DenseHashTable<FakeKey, usize, FakeKeyTrait> table = {};
+  table.insert(k0, 0);
+  table.insert(k1, 1);
+  table.insert(k2, 2);
+  table.insert(k3, 3);
+
+  // The last entry is swapped into the gap
+  table.remove(k1);
+  TEST_EQ(static_cast<usize>(3), table.used);
+  TEST_EQ(false, table.contains(k1));
+  TEST_EQ(k0.i, table.key_view()[0].i);
+  TEST_EQ(k3.i, table.key_view()[1].i);
+  TEST_EQ(k2.i, table.key_view()[2].i);
+  TEST_EQ(static_cast<usize>(3), *table.get_val(k3));
+  TEST_EQ(static_cast<usize>(2), *table.get_val(k2));
+
+  TEST_EQ(static_cast<usize>(2), table.take(k2));
+  TEST_EQ(static_cast<usize>(2), table.used);
+  TEST_EQ(false, table.contains(k2));
+
+  usize* created = table.get_or_create(k1);
+  TEST_EQ(static_cast<usize>(0), *created);
+  TEST_EQ(created, table.get_or_create(k1));
+  TEST_EQ(k1.i, table.key_view()[2].i);
+
+  // Churn through lots of removes to exercise tombstone cleanup
+  for (usize i = 0; i < 200; ++i) {
+    const FakeKey k = gen();
+    table.insert(k, usize{ i });
+    TEST_EQ(i, *table.get_val(k));
+    table.remove(k);
+    TEST_EQ(false, table.contains(k));
+  }
+
+  TEST_EQ(static_cast<usize>(3), table.used);
+  TEST_EQ(static_cast<usize>(0), *table.get_val(k0));
+  TEST_EQ(static_cast<usize>(3), *table.get_val(k3));
+  TEST_EQ(static_cast<usize>(0), *table.get_val(k1));
+  TEST_EQ(true, table.slot_capacity <= 16);
+
+  Hash::DenseHashTable<FakeKey, usize, FakeKeyTrait> moved = std::move(table);
+  TEST_EQ(static_cast<usize>(0), table.used);
+  TEST_EQ(static_cast<usize>(3), moved.used);
+  TEST_EQ(static_cast<usize>(3), *moved.get_val(k3));
+}
+
+TEST_FUNCTION(Hash, FrozenHashTable) {
+  StringInterner interner = {};
+
+  struct Val {
+    u32 a;
+    u64 b;
+  };
+
+  InternHashTable<Val> table = {};
+  for (u32 i = 0; i < 100; ++i) {
+    const OwnedArr<const char> key = format("key{}", i);
+    table.insert(interner.intern(view_arr(key)), Val{ i, static_cast<u64>(i) * 3 });
+  }
+
+  Array<u8> bytes = {};
+  {
+    Serializer<Array<u8>, ByteOrder::LittleEndian> ser(bytes);
+    Hash::freeze_hash_table(ser, table);
+  }
+
+  // Copy into aligned memory as if it had been mapped from a file
+  OwnedArr<u64> aligned = new_arr<u64>((bytes.size + 7) / 8);
+  memcpy_ts(reinterpret_cast<u8*>(aligned.data), bytes.size, bytes.data, bytes.size);
+  const ViewArr<const u8> frozen = { reinterpret_cast<const u8*>(aligned.data), bytes.size };
+
+  Hash::FrozenHashTable<Val> ft = {};
+  TEST_EQ(true, ft.load(frozen));
+  TEST_EQ(table.used, ft.size());
+
+  for (u32 i = 0; i < 100; ++i) {
+    const OwnedArr<const char> key = format("key{}", i);
+    const Val* v = ft.get_val(view_arr(key));
+    TEST_NEQ(static_cast<const Val*>(nullptr), v);
+    if (v == nullptr) continue;
+    TEST_EQ(i, v->a);
+    TEST_EQ(static_cast<u64>(i) * 3, v->b);
+
+    const InternString* s = interner.find(view_arr(key));
+    TEST_EQ(v, ft.get_val(s));
+  }
+
+  TEST_EQ(static_cast<const Val*>(nullptr), ft.get_val(lit_view_arr("key100")));
+  TEST_EQ(static_cast<const Val*>(nullptr), ft.get_val(lit_view_arr("")));
+
+  for (usize i = 0; i < ft.size(); ++i) {
+    const InternString* s = interner.find(ft.key_at(i).data, ft.key_at(i).size);
+    TEST_NEQ(static_cast<const InternString*>(nullptr), s);
+    TEST_EQ(table.get_val(s)->a, ft.val_at(i).a);
+  }
+
+  // Truncated or corrupt data is rejected without reading past the end
+  Hash::FrozenHashTable<Val> bad = {};
+  TEST_EQ(false, bad.load({ frozen.data, frozen.size - 1 }));
+  TEST_EQ(false, bad.load({ frozen.data, 8 }));
+
+  {
+    const Hash::FrozenHeader& h = *ft.header;
+    u8* raw = reinterpret_cast<u8*>(aligned.data);
+    const auto corrupt = [&](usize offset, const auto& value) {
+      using V = std::remove_cvref_t<decltype(value)>;
+      V original;
+      memcpy_ts(reinterpret_cast<u8*>(&original), sizeof(V), raw + offset, sizeof(V));
+      memcpy_ts(raw + offset, sizeof(V), reinterpret_cast<const u8*>(&value), sizeof(V));
+      const bool loaded = bad.load(frozen);
+      memcpy_ts(raw + offset, sizeof(V), reinterpret_cast<const u8*>(&original), sizeof(V));
+      return loaded;
+    };
+
+    usize used_slot = 0;
+    usize empty_slot = 0;
+    for (usize i = 0; i < h.slot_count; ++i) {
+      if (ft.slots[i] == Hash::FROZEN_EMPTY_SLOT) empty_slot = i;
+      else used_slot = i;
+    }
+
+    const usize slots = static_cast<usize>(h.slots_offset);
+    const usize entries = static_cast<usize>(h.entries_offset);
+    TEST_EQ(false, corrupt(slots + used_slot * sizeof(u32), static_cast<u32>(h.entry_count)));
+    TEST_EQ(false, corrupt(slots + used_slot * sizeof(u32), Hash::FROZEN_EMPTY_SLOT));
+    TEST_EQ(false, corrupt(slots + empty_slot * sizeof(u32), u32{ 0 }));
+
+    const usize last_entry = entries + (ft.size() - 1) * sizeof(Hash::FrozenEntry);
+    TEST_EQ(false, corrupt(last_entry + offsetof(Hash::FrozenEntry, string_offset), u64{ 0 }));
+    TEST_EQ(false, corrupt(last_entry + offsetof(Hash::FrozenEntry, string_offset), static_cast<u64>(h.total_size + 1)));
+    TEST_EQ(false, corrupt(last_entry + offsetof(Hash::FrozenEntry, string_len), static_cast<u64>(h.total_size)));
+
+    // Undoing each change leaves a valid table
+    TEST_EQ(true, bad.load(frozen));
+  }
+
+  Hash::FrozenHashTable<u32> wrong_type = {};
+  TEST_EQ(false, wrong_type.load(frozen));
+}
@@ -0,0 +1,136 @@
+#include <AxleUtil/io.h>
+
+#include <cstdio>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  // Sends both of this thread's buffers to one temporary file, so the order they were written in can be checked
+  struct CaptureOutput {
+    FILE* file = std::tmpfile();
+
+    CaptureOutput() {
+      if (file == nullptr) return;
+      IO::set_output(IO::Stream::Out, file);
+      IO::set_output(IO::Stream::Err, file);
+    }
+
+    CaptureOutput(const CaptureOutput&) = delete;
+    CaptureOutput& operator=(const CaptureOutput&) = delete;
+
+    ~CaptureOutput() {
+      if (file == nullptr) return;
+      IO::flush();
+      IO::set_output(IO::Stream::Out, stdout);
+      IO::set_output(IO::Stream::Err, stderr);
+      IO::set_flush_lines(IO::Stream::Out, 32);
+      IO::set_flush_lines(IO::Stream::Err, 1);
+      std::fclose(file);
+    }
+
+    Array<char> written() const {
+      std::fflush(file);
+      const usize size = static_cast<usize>(std::ftell(file));
+
+      Array<char> result = {};
+      result.insert_uninit(size);
+      std::rewind(file);
+      const usize read = std::fread(result.data, 1, size, file);
+      ASSERT(read == size);
+      return result;
+    }
+  };
+
+  void fill_lines(Array<char>& arr, char c, usize line_len, usize count) {
+    for (usize i = 0; i < count; ++i) {
+      for (usize j = 1; j < line_len; ++j) {
+        arr.insert(c);
+      }
+      arr.insert('\n');
+    }
+  }
+}
+
+TEST_FUNCTION(IO, split_lines) {
+  CaptureOutput capture;
+  TEST_EQ(true, capture.file != nullptr);
+  IO::set_flush_lines(IO::Stream::Out, 2);
+
+  // Lines only go out once two of them are whole
+  IO::write(IO::Stream::Out, "one\ntw", 6);
+  TEST_STR_EQ(lit_view_arr(""), view_arr(capture.written()));
+
+  IO::write(IO::Stream::Out, "o\nthr", 5);
+  TEST_STR_EQ(lit_view_arr("one\ntwo\n"), view_arr(capture.written()));
+
+  IO::write(IO::Stream::Out, "ee", 2);
+  TEST_STR_EQ(lit_view_arr("one\ntwo\n"), view_arr(capture.written()));
+
+  IO::flush();
+  TEST_STR_EQ(lit_view_arr("one\ntwo\nthree"), view_arr(capture.written()));
+}
+
+TEST_FUNCTION(IO, partial_line_print) {
+  CaptureOutput capture;
+  TEST_EQ(true, capture.file != nullptr);
+
+  // A print that stops part way through a line is shown straight away
+  IO::format("{} ...\t", lit_view_arr("test"));
+  TEST_STR_EQ(lit_view_arr("test ...\t"), view_arr(capture.written()));
+
+  IO::print("Success\n");
+  TEST_STR_EQ(lit_view_arr("test ...\t"), view_arr(capture.written()));
+
+  IO::print("next ...\t");
+  TEST_STR_EQ(lit_view_arr("test ...\tSuccess\nnext ...\t"), view_arr(capture.written()));
+}
+
+TEST_FUNCTION(IO, stdout_before_stderr) {
+  CaptureOutput capture;
+  TEST_EQ(true, capture.file != nullptr);
+
+  IO::print("out\n");
+  IO::err_print("err\n");
+  TEST_STR_EQ(lit_view_arr("out\nerr\n"), view_arr(capture.written()));
+
+  IO::print("before lock\n");
+  Array<char> under_lock = {};
+  {
+    IO_Single::ScopeLock lock;
+    under_lock = capture.written();
+  }
+  TEST_STR_EQ(lit_view_arr("out\nerr\nbefore lock\n"), view_arr(under_lock));
+}
+
+TEST_FUNCTION(IO, full_buffer) {
+  CaptureOutput capture;
+  TEST_EQ(true, capture.file != nullptr);
+  IO::set_flush_lines(IO::Stream::Out, 1000);
+
+  // More than the 16KB buffer, so it fills up long before 1000 lines
+  constexpr usize LINE_LEN = 100;
+  constexpr usize LINE_COUNT = 200;
+  Array<char> expected = {};
+  fill_lines(expected, 'x', LINE_LEN, LINE_COUNT);
+  IO::write(IO::Stream::Out, expected.data, expected.size);
+
+  const usize written = capture.written().size;
+  TEST_EQ(true, written > 0);
+  TEST_EQ(true, written < expected.size);
+  TEST_EQ(static_cast<usize>(0), written % LINE_LEN);
+
+  IO::flush();
+  TEST_STR_EQ(view_arr(expected), view_arr(capture.written()));
+
+  // A single line bigger than the buffer is the only thing that gets split
+  const usize before = expected.size;
+  for (usize i = 0; i < LINE_LEN * LINE_COUNT; ++i) {
+    expected.insert('y');
+  }
+  IO::write(IO::Stream::Out, expected.data + before, expected.size - before);
+  TEST_EQ(true, capture.written().size > before);
+
+  IO::flush();
+  TEST_STR_EQ(view_arr(expected), view_arr(capture.written()));
+}
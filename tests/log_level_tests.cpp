@@ -0,0 +1,56 @@
+#include <AxleUtil/io.h>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  LOG::Gate TEST_GATE{ lit_view_arr("test") };
+
+  void discard(const ViewArr<const u8>&, void*) {}
+
+  int counted(int& count) {
+    count += 1;
+    return count;
+  }
+}
+
+static_assert(LOG::level_enabled(LOG::Level::Error) == (AXLE_LOG_MIN_LEVEL <= 2));
+static_assert(LOG::level_enabled(LOG::Level::Debug) == (AXLE_LOG_MIN_LEVEL <= 0));
+
+TEST_FUNCTION(LogLevel, gates) {
+  // Capture into a binary log so nothing reaches stderr
+  LOG::BinaryLog log = { discard, nullptr };
+  LOG::set_binary_log(&log);
+
+  const usize start = log.bytes.size;
+  TEST_GATE.set(false);
+  TEST_EQ(false, TEST_GATE.enabled());
+  LOG::debug(TEST_GATE, "gated {}", 1);
+  LOG::warn(TEST_GATE, "gated");
+  LOG::error(TEST_GATE, "gated {} {}", 1, 2);
+  TEST_EQ(start, log.bytes.size);
+
+  TEST_GATE.set(true);
+  LOG::error(TEST_GATE, "gated {} {}", 1, 2);
+  TEST_EQ(LOG::level_enabled(LOG::Level::Error), log.bytes.size > start);
+
+  LOG::set_binary_log(nullptr);
+}
+
+TEST_FUNCTION(LogLevel, macros) {
+  LOG::BinaryLog log = { discard, nullptr };
+  LOG::set_binary_log(&log);
+
+  // Arguments are only evaluated for levels that are compiled in
+  int count = 0;
+  AXLE_LOG_DEBUG("{}", counted(count));
+  AXLE_LOG_WARN("{}", counted(count));
+  AXLE_LOG_ERROR(TEST_GATE, "{}", counted(count));
+
+  const int expected = static_cast<int>(LOG::level_enabled(LOG::Level::Debug))
+                     + static_cast<int>(LOG::level_enabled(LOG::Level::Warn))
+                     + static_cast<int>(LOG::level_enabled(LOG::Level::Error));
+  TEST_EQ(expected, count);
+
+  LOG::set_binary_log(nullptr);
+}
@@ -99,6 +99,10 @@ TEST_FUNCTION(Math, pows_and_logs) {
     while (true) {
       TEST_EQ(v, pow_10(i));
       TEST_EQ(i, log_10_floor(v));
+      TEST_EQ(i, log_10_floor(v + 1));
+      if (v > 1) {
+        TEST_EQ(i - 1, log_10_floor(v - 1));
+      }
 
       if (v > UINT64_MAX / 10) {
         break;
@@ -106,6 +110,8 @@ TEST_FUNCTION(Math, pows_and_logs) {
       v *= 10;
       i += 1;
     }
+
+    TEST_EQ(19llu, log_10_floor(UINT64_MAX));
   }
 
   TEST_EQ(1llu, pow_16(0));
@@ -0,0 +1,95 @@
+#include <AxleUtil/parse.h>
+#include <AxleUtil/format.h>
+
+#include <charconv>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  template<typename T>
+  constexpr T parsed(const char* str) {
+    T t = 0;
+    ASSERT(parse_number(ViewArr<const char>{ str, strlen_ts(str) }, t));
+    return t;
+  }
+
+  template<typename T>
+  constexpr bool fails(const char* str) {
+    T t = 0;
+    return !parse_number(ViewArr<const char>{ str, strlen_ts(str) }, t);
+  }
+}
+
+static_assert(parsed<u32>("12345678") == 12345678);
+static_assert(parsed<u64>("18446744073709551615") == 18446744073709551615ull);
+static_assert(parsed<i8>("-128") == -128);
+static_assert(parsed<u16>("0xBEef") == 0xBEEF);
+static_assert(parsed<u8>("0b1010") == 10);
+static_assert(parsed<i32>("-0x10") == -16);
+static_assert(fails<u64>("18446744073709551616"));
+static_assert(fails<u8>("256"));
+static_assert(fails<i8>("128"));
+static_assert(fails<u32>("-1"));
+static_assert(fails<u32>(""));
+static_assert(fails<u32>("12a"));
+static_assert(fails<u32>("0x"));
+static_assert(fails<u64>("0x10000000000000000"));
+
+TEST_FUNCTION(Parse, integers_match_from_chars) {
+  u64 state = 0x853c49e6748fea9bull;
+  char buffer[32];
+
+  for (usize round = 0; round < 20000; ++round) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+
+    // Every length of number, not just the ones near 2^64
+    const u64 value = state >> (round % 64);
+    const std::to_chars_result res = std::to_chars(buffer, buffer + array_size(buffer), value);
+    const ViewArr<const char> str = { buffer, static_cast<usize>(res.ptr - buffer) };
+
+    u64 u = 0;
+    TEST_EQ(true, parse_number(str, u));
+    TEST_EQ(value, u);
+
+    u32 u32_val = 0;
+    TEST_EQ(value <= 0xFFFFFFFF, parse_number(str, u32_val));
+
+    const i64 signed_value = -static_cast<i64>(value >> 1);
+    const std::to_chars_result sres = std::to_chars(buffer, buffer + array_size(buffer), signed_value);
+    i64 i = 0;
+    TEST_EQ(true, parse_number({ buffer, static_cast<usize>(sres.ptr - buffer) }, i));
+    TEST_EQ(signed_value, i);
+  }
+
+  i64 min = 0;
+  TEST_EQ(true, parse_number(lit_view_arr("-9223372036854775808"), min));
+  TEST_EQ(std::numeric_limits<i64>::min(), min);
+  TEST_EQ(false, parse_number(lit_view_arr("9223372036854775808"), min));
+
+  // Leading zeros dont count towards overflow
+  u64 zeros = 0;
+  TEST_EQ(true, parse_number(lit_view_arr("000000000000000000000000042"), zeros));
+  TEST_EQ(static_cast<u64>(42), zeros);
+
+  // Left alone on failure
+  u16 unchanged = 7;
+  TEST_EQ(false, parse_number(lit_view_arr("12 "), unchanged));
+  TEST_EQ(static_cast<u16>(7), unchanged);
+}
+
+TEST_FUNCTION(Parse, floats) {
+  double d = 0;
+  TEST_EQ(true, parse_number(lit_view_arr("-1.5e3"), d));
+  TEST_EQ(-1500.0, d);
+  TEST_EQ(true, parse_number(lit_view_arr("0.1"), d));
+  TEST_EQ(0.1, d);
+
+  float f = 0;
+  TEST_EQ(true, parse_number(lit_view_arr("3.25"), f));
+  TEST_EQ(3.25f, f);
+
+  TEST_EQ(false, parse_number(lit_view_arr("1.0x"), f));
+  TEST_EQ(false, parse_number(lit_view_arr(""), f));
+  TEST_EQ(false, parse_number(lit_view_arr("1e999"), d));
+}
@@ -0,0 +1,189 @@
+#include <AxleUtil/safe_lib.h>
+#include <AxleUtil/strings.h>
+#include <AxleUtil/simd.h>
+#include <AxleUtil/stdext/compare.h>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  constexpr usize BUFFER_SIZE = 256;
+
+  // Runs test once for every level this cpu supports, restoring the default afterwards
+  template<typename L>
+  void for_each_level(L&& test) {
+    const SIMD::Level max = SIMD::detected_level();
+    for (u8 l = 0; l <= static_cast<u8>(max); ++l) {
+      SIMD::set_level(static_cast<SIMD::Level>(l));
+      test();
+    }
+    SIMD::set_level(max);
+  }
+
+  void fill_pattern(char* data, usize size) {
+    for (usize i = 0; i < size; ++i) {
+      data[i] = static_cast<char>('a' + (i % 23));
+    }
+  }
+}
+
+// All of these have to work in constant evaluation too
+static_assert(memeq_ts<char>("hello", "hello", 5));
+static_assert(!memeq_ts<char>("hello", "hellp", 5));
+static_assert(strlen_ts("hello") == 5);
+static_assert(streq_ts("hello", "hello"));
+static_assert(!streq_ts("hello", "hell"));
+static_assert(find_byte(lit_view_arr("hello"), 'l') != nullptr);
+static_assert(find_any_of(lit_view_arr("a/b\\c"), lit_view_arr("\\/")) != nullptr);
+static_assert(find_substring(lit_view_arr("hello world"), lit_view_arr("o w")) != nullptr);
+static_assert(find_substring(lit_view_arr("hello world"), lit_view_arr("ow")) == nullptr);
+static_assert(lexicographic_order(lit_view_arr("abc"), lit_view_arr("abd")) < 0);
+
+TEST_FUNCTION(SIMD, memeq) {
+  for_each_level([&]() {
+    alignas(64) char a[BUFFER_SIZE];
+    alignas(64) char b[BUFFER_SIZE];
+    fill_pattern(a, BUFFER_SIZE);
+    fill_pattern(b, BUFFER_SIZE);
+
+    for (usize offset = 0; offset < 4; ++offset) {
+      for (usize len = 0; len + offset <= 100; ++len) {
+        TEST_EQ(true, memeq_ts<char>(a + offset, b + offset, len));
+
+        // A difference in every position must be seen
+        for (usize d = 0; d < len; ++d) {
+          b[offset + d] = '#';
+          TEST_EQ(false, memeq_ts<char>(a + offset, b + offset, len));
+          TEST_EQ(d, SIMD::mismatch(reinterpret_cast<const u8*>(a + offset),
+                                    reinterpret_cast<const u8*>(b + offset), len));
+          b[offset + d] = a[offset + d];
+        }
+
+        TEST_EQ(len, SIMD::mismatch(reinterpret_cast<const u8*>(a + offset),
+                                    reinterpret_cast<const u8*>(b + offset), len));
+      }
+    }
+  });
+}
+
+TEST_FUNCTION(SIMD, strlen_streq) {
+  for_each_level([&]() {
+    alignas(64) char a[BUFFER_SIZE];
+    alignas(64) char b[BUFFER_SIZE];
+
+    for (usize offset = 0; offset < 33; ++offset) {
+      for (usize len = 0; len + offset < 120; ++len) {
+        fill_pattern(a, BUFFER_SIZE);
+        fill_pattern(b, BUFFER_SIZE);
+        a[offset + len] = '\0';
+        b[offset + len] = '\0';
+
+        TEST_EQ(len, strlen_ts(a + offset));
+        TEST_EQ(true, streq_ts(a + offset, b + offset));
+
+        if (len > 0) {
+          b[offset + len - 1] = '#';
+          TEST_EQ(false, streq_ts(a + offset, b + offset));
+          b[offset + len - 1] = '\0';
+          TEST_EQ(false, streq_ts(a + offset, b + offset));
+          TEST_EQ(false, streq_ts(b + offset, a + offset));
+        }
+      }
+    }
+  });
+}
+
+TEST_FUNCTION(SIMD, find) {
+  for_each_level([&]() {
+    char data[BUFFER_SIZE];
+    for (usize i = 0; i < BUFFER_SIZE; ++i) {
+      data[i] = 'x';
+    }
+
+    for (usize len = 0; len < 100; ++len) {
+      const ViewArr<const char> str = { data, len };
+      TEST_EQ(static_cast<const char*>(nullptr), find_byte(str, '.'));
+      TEST_EQ(static_cast<const char*>(nullptr), find_any_of(str, lit_view_arr("./\\")));
+
+      for (usize at = 0; at < len; ++at) {
+        data[at] = '/';
+        TEST_EQ(static_cast<const char*>(data + at), find_byte(str, '/'));
+        TEST_EQ(static_cast<const char*>(data + at), find_any_of(str, lit_view_arr(".\\/")));
+        TEST_EQ(static_cast<const char*>(data + at), find_any_of(str, lit_view_arr("abcdefghijklmnopqrstuvw/")));
+
+        // First match wins
+        if (at + 1 < len) {
+          data[len - 1] = '.';
+          TEST_EQ(static_cast<const char*>(data + at), find_any_of(str, lit_view_arr("./")));
+          data[len - 1] = 'x';
+        }
+        data[at] = 'x';
+      }
+    }
+
+    TEST_EQ(static_cast<const char*>(nullptr), find_any_of(lit_view_arr("hello"), {}));
+  });
+}
+
+TEST_FUNCTION(SIMD, find_substring) {
+  for_each_level([&]() {
+    char data[BUFFER_SIZE];
+    for (usize i = 0; i < BUFFER_SIZE; ++i) {
+      data[i] = 'a';
+    }
+
+    const ViewArr<const char> needles[] = {
+      lit_view_arr("b"), lit_view_arr("ab"), lit_view_arr("aab"),
+      lit_view_arr("abcdefghijklmnopqrstuvwxyz0123456789"),
+    };
+
+    for (const ViewArr<const char>& needle : needles) {
+      for (usize len = 0; len < 120; ++len) {
+        const ViewArr<const char> str = { data, len };
+        TEST_EQ(static_cast<const char*>(nullptr), find_substring(str, needle));
+
+        for (usize at = 0; at + needle.size <= len; ++at) {
+          memcpy_ts(data + at, needle.size, needle.data, needle.size);
+
+          const char* expected = data + at;
+          // Prefixes of 'a's can make an earlier match for needles that start with 'a'
+          for (usize early = 0; early < at; ++early) {
+            if (memeq_ts<char>(data + early, needle.data, needle.size)) {
+              expected = data + early;
+              break;
+            }
+          }
+
+          TEST_EQ(expected, find_substring(str, needle));
+
+          for (usize i = 0; i < needle.size; ++i) {
+            data[at + i] = 'a';
+          }
+        }
+      }
+    }
+
+    TEST_EQ(static_cast<const char*>(data), find_substring({ data, 4 }, {}));
+  });
+}
+
+TEST_FUNCTION(SIMD, lexicographic_order) {
+  for_each_level([&]() {
+    char a[BUFFER_SIZE];
+    char b[BUFFER_SIZE];
+    fill_pattern(a, BUFFER_SIZE);
+    fill_pattern(b, BUFFER_SIZE);
+
+    for (usize len = 1; len < 80; ++len) {
+      const ViewArr<const char> l = { a, len };
+      const ViewArr<const char> r = { b, len };
+      TEST_EQ(std::strong_ordering::equivalent, lexicographic_order(l, r));
+      TEST_EQ(std::strong_ordering::less, lexicographic_order(view_arr(l, 0, len - 1), r));
+
+      b[len - 1] = '~';
+      TEST_EQ(std::strong_ordering::less, lexicographic_order(l, r));
+      TEST_EQ(std::strong_ordering::greater, lexicographic_order(r, l));
+      b[len - 1] = a[len - 1];
+    }
+  });
+}
@@ -0,0 +1,131 @@
+#include <AxleUtil/split.h>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+TEST_FUNCTION(Split, lines) {
+  const auto data = lit_view_arr("first\nsecond\r\n\nlast\r\n");
+
+  const ViewArr<const char> expected[] = {
+    lit_view_arr("first"), lit_view_arr("second"), lit_view_arr(""), lit_view_arr("last"),
+  };
+
+  LineSplitter lines = { data };
+  ViewArr<const char> line;
+  usize count = 0;
+  while (lines.next(line)) {
+    TEST_EQ(true, count < array_size(expected));
+    TEST_STR_EQ(expected[count], line);
+    // Views are straight into the source
+    TEST_EQ(true, line.data >= data.data && line.data + line.size <= data.data + data.size);
+    count += 1;
+  }
+  TEST_EQ(array_size(expected), count);
+
+  lines = { lit_view_arr("no ending") };
+  TEST_EQ(true, lines.next(line));
+  TEST_STR_EQ(lit_view_arr("no ending"), line);
+  TEST_EQ(false, lines.next(line));
+
+  lines = { ViewArr<const char>{} };
+  TEST_EQ(false, lines.next(line));
+}
+
+TEST_FUNCTION(Split, fields) {
+  {
+    FieldSplitter fields = { lit_view_arr("a,b;;c,"), lit_view_arr(",;") };
+    const ViewArr<const char> expected[] = {
+      lit_view_arr("a"), lit_view_arr("b"), lit_view_arr(""), lit_view_arr("c"), lit_view_arr(""),
+    };
+
+    ViewArr<const char> field;
+    usize count = 0;
+    while (fields.next(field)) {
+      TEST_EQ(true, count < array_size(expected));
+      TEST_STR_EQ(expected[count], field);
+      TEST_EQ(false, fields.last_quoted);
+      count += 1;
+    }
+    TEST_EQ(array_size(expected), count);
+  }
+
+  {
+    FieldSplitter fields = { lit_view_arr("1,\"x,\ny\",\"say \"\"hi\"\"\",\"open"), lit_view_arr(","), '"' };
+
+    ViewArr<const char> field;
+    TEST_EQ(true, fields.next(field));
+    TEST_STR_EQ(lit_view_arr("1"), field);
+    TEST_EQ(false, fields.last_quoted);
+
+    TEST_EQ(true, fields.next(field));
+    TEST_STR_EQ(lit_view_arr("x,\ny"), field);
+    TEST_EQ(true, fields.last_quoted);
+
+    TEST_EQ(true, fields.next(field));
+    TEST_STR_EQ(lit_view_arr("say \"\"hi\"\""), field);
+
+    // Unterminated quote runs to the end
+    TEST_EQ(true, fields.next(field));
+    TEST_STR_EQ(lit_view_arr("open"), field);
+    TEST_EQ(false, fields.next(field));
+  }
+
+  {
+    FieldSplitter fields = { ViewArr<const char>{}, lit_view_arr(",") };
+    ViewArr<const char> field;
+    TEST_EQ(false, fields.next(field));
+  }
+
+  {
+    // Records are found by the delimiter, so a quoted line ending stays inside its field
+    FieldSplitter fields = { lit_view_arr("a,\"two\nlines\"\r\nb,c\r\nd\n"), lit_view_arr(",\n"), '"' };
+    const ViewArr<const char> expected[] = {
+      lit_view_arr("a"), lit_view_arr("two\nlines"), lit_view_arr("b"), lit_view_arr("c"), lit_view_arr("d"),
+    };
+    const bool record_end[] = { false, true, false, true, true };
+
+    ViewArr<const char> field;
+    usize count = 0;
+    while (fields.next(field)) {
+      TEST_EQ(true, count < array_size(expected));
+      TEST_STR_EQ(expected[count], field);
+      TEST_EQ(record_end[count], fields.end_of_record());
+      count += 1;
+    }
+    TEST_EQ(array_size(expected), count);
+    TEST_EQ('\n', fields.last_delimiter);
+  }
+}
+
+TEST_FUNCTION(Split, line_stream) {
+  const auto data = lit_view_arr("alpha\r\nbeta\ngamma delta\r\n\nend");
+
+  const ViewArr<const char> expected[] = {
+    lit_view_arr("alpha"), lit_view_arr("beta"), lit_view_arr("gamma delta"), lit_view_arr(""), lit_view_arr("end"),
+  };
+
+  // Every chunk size, so lines and "\r\n" get cut in every place
+  for (usize chunk_size = 1; chunk_size <= data.size; ++chunk_size) {
+    LineStream stream = {};
+    ViewArr<const char> line;
+    usize count = 0;
+
+    for (usize start = 0; start < data.size; start += chunk_size) {
+      stream.push(view_arr(data, start, smaller(chunk_size, data.size - start)));
+
+      while (stream.next(line)) {
+        TEST_EQ(true, count < array_size(expected));
+        TEST_STR_EQ(expected[count], line);
+        count += 1;
+      }
+    }
+
+    while (stream.finish(line)) {
+      TEST_EQ(true, count < array_size(expected));
+      TEST_STR_EQ(expected[count], line);
+      count += 1;
+    }
+
+    TEST_EQ(array_size(expected), count);
+  }
+}
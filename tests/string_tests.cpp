@@ -1,4 +1,5 @@
 #include <AxleUtil/strings.h>
+#include <AxleUtil/files.h>
 #include <AxleUtil/stdext/compare.h>
 
 #include <AxleTest/unit_tests.h>
@@ -141,6 +142,355 @@ TEST_FUNCTION(Interned_Strings, find) {
 }
 
 
+TEST_FUNCTION(Interned_Strings, find_batch) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 40;
+  const InternString* interned[COUNT];
+  ViewArr<const char> strs[COUNT + 2];
+  for (usize i = 0; i < COUNT; ++i) {
+    interned[i] = interner.format_intern("str{}", i);
+    strs[i] = view_arr(interned[i]);
+  }
+  strs[COUNT] = lit_view_arr("missing");
+  strs[COUNT + 1] = {};
+
+  const InternString* found[COUNT + 2] = {};
+  interner.find_batch(view_arr(strs), view_arr(found));
+
+  for (usize i = 0; i < COUNT; ++i) {
+    TEST_EQ(interned[i], found[i]);
+  }
+  TEST_EQ(static_cast<const InternString*>(nullptr), found[COUNT]);
+  TEST_EQ(static_cast<const InternString*>(&interner.empty_string), found[COUNT + 1]);
+}
+
+TEST_FUNCTION(Interned_Strings, intern_batch) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 1000;
+  const InternString* existing = interner.intern(lit_view_arr("str7"));
+
+  Format::ArrayFormatter names[COUNT];
+  ViewArr<const char> strs[COUNT + 3];
+  for (usize i = 0; i < COUNT; ++i) {
+    Format::format_to(names[i], "str{}", i);
+    strs[i] = view_arr(names[i]);
+  }
+  // Duplicates inside the batch and the empty string
+  strs[COUNT] = lit_view_arr("str3");
+  strs[COUNT + 1] = {};
+  strs[COUNT + 2] = lit_view_arr("str999");
+
+  const InternString* interned[COUNT + 3] = {};
+  interner.intern_batch(view_arr(strs), view_arr(interned));
+
+  TEST_EQ(COUNT, interner.table.num_full);
+  TEST_EQ(existing, interned[7]);
+  TEST_EQ(interned[3], interned[COUNT]);
+  TEST_EQ(static_cast<const InternString*>(&interner.empty_string), interned[COUNT + 1]);
+  TEST_EQ(interned[999], interned[COUNT + 2]);
+
+  for (usize i = 0; i < COUNT; ++i) {
+    TEST_STR_EQ(strs[i], interned[i]);
+    TEST_EQ(interned[i], interner.find(strs[i]));
+    TEST_EQ(interned[i], interner.intern(strs[i]));
+  }
+
+  // New strings are laid out one after the other
+  TEST_EQ(true, interned[1] < interned[2] && interned[2] < interned[3]);
+}
+
+TEST_FUNCTION(Interned_Strings, generations) {
+  StringInterner base = {};
+  const InternString* shared = base.intern(lit_view_arr("shared"));
+
+  {
+    StringInterner child{ &base };
+    TEST_EQ(shared, child.intern(lit_view_arr("shared")));
+    const InternString* request = child.intern(lit_view_arr("request"));
+    TEST_EQ(static_cast<usize>(1), child.table.num_full);
+
+    StringInterner grandchild{ &child };
+
+    // Parents are read only until their children are gone
+    TEST_EQ(static_cast<u32>(1), base.children.load());
+    TEST_EQ(static_cast<u32>(1), child.children.load());
+    TEST_EQ(static_cast<u32>(0), grandchild.children.load());
+
+    TEST_EQ(shared, grandchild.find(lit_view_arr("shared")));
+    TEST_EQ(static_cast<const InternString*>(&base.empty_string), grandchild.intern(nullptr, 0));
+    TEST_EQ(request, grandchild.intern(lit_view_arr("request")));
+    TEST_EQ(static_cast<usize>(0), grandchild.table.num_full);
+    TEST_EQ(static_cast<const InternString*>(nullptr), base.find(lit_view_arr("request")));
+
+    ViewArr<const char> strs[3] = { lit_view_arr("shared"), lit_view_arr("request"), lit_view_arr("new") };
+    const InternString* found[3] = {};
+    grandchild.intern_batch(view_arr(strs), view_arr(found));
+    TEST_EQ(shared, found[0]);
+    TEST_EQ(request, found[1]);
+    TEST_EQ(found[2], grandchild.find(lit_view_arr("new")));
+    TEST_EQ(static_cast<const InternString*>(nullptr), child.find(lit_view_arr("new")));
+
+    // Dropping a generation keeps the parents intact
+    grandchild.reset();
+    for (usize round = 0; round < 4; ++round) {
+      for (usize i = 0; i < 500; ++i) {
+        grandchild.format_intern("temp{}", i);
+      }
+      TEST_EQ(static_cast<usize>(500), grandchild.table.num_full);
+
+      grandchild.reset();
+      TEST_EQ(static_cast<usize>(0), grandchild.table.num_full);
+      TEST_EQ(static_cast<const InternString*>(nullptr), grandchild.find(lit_view_arr("temp0")));
+      TEST_EQ(request, grandchild.find(lit_view_arr("request")));
+    }
+  }
+
+  TEST_EQ(shared, base.find(lit_view_arr("shared")));
+  TEST_EQ(static_cast<usize>(1), base.table.num_full);
+
+  TEST_EQ(static_cast<u32>(0), base.children.load());
+  TEST_NEQ(shared, base.intern(lit_view_arr("request")));
+  TEST_EQ(static_cast<usize>(2), base.table.num_full);
+}
+
+TEST_FUNCTION(Interned_Strings, table_slots) {
+  StringInterner interner = {};
+
+  constexpr usize COUNT = 5000;
+  const InternString* interned[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    interned[i] = interner.format_intern("s{}", i);
+  }
+
+  TEST_EQ(COUNT, interner.table.num_full);
+  TEST_EQ(static_cast<usize>(0), interner.table.size & (interner.table.size - 1));
+
+  // Lengths are shared by most strings, so hash fragments do the filtering
+  for (usize i = 0; i < COUNT; ++i) {
+    const Table::Slot* slot = interner.table.find(interned[i]->string, interned[i]->len, interned[i]->hash);
+    TEST_EQ(interned[i], slot->string);
+    TEST_EQ(Table::hash_fragment(interned[i]->hash), slot->hash_fragment);
+    TEST_EQ(static_cast<u32>(interned[i]->len), slot->len_fragment);
+
+    TEST_EQ(interned[i], interner.find(view_arr(interned[i])));
+  }
+
+  TEST_EQ(static_cast<const InternString*>(nullptr), interner.find(lit_view_arr("s5000")));
+}
+
+TEST_FUNCTION(Interned_Strings, snapshot) {
+  constexpr auto snapshot_path = lit_view_arr("./interner_snapshot.bin");
+  constexpr usize COUNT = 500;
+
+  {
+    StringInterner interner = {};
+    for (usize i = 0; i < COUNT; ++i) {
+      interner.format_intern("name{}", i);
+    }
+
+    TEST_EQ(FILES::ErrorCode::OK, interner.save_snapshot(snapshot_path));
+  }
+
+  StringInterner interner = {};
+  TEST_EQ(FILES::ErrorCode::OK, interner.load_snapshot(snapshot_path));
+  TEST_EQ(true, interner.snapshot.is_mapped());
+  TEST_EQ(COUNT, interner.table.num_full);
+
+  const ViewArr<const u8> mapping = interner.snapshot.view();
+  const auto in_mapping = [&](const InternString* str) {
+    const u8* p = reinterpret_cast<const u8*>(str->string);
+    return mapping.data <= p && p < mapping.data + mapping.size;
+  };
+
+  for (usize i = 0; i < COUNT; ++i) {
+    Format::ArrayFormatter name = {};
+    Format::format_to(name, "name{}", i);
+
+    const InternString* found = interner.find(view_arr(name));
+    TEST_NEQ(static_cast<const InternString*>(nullptr), found);
+    TEST_STR_EQ(view_arr(name), found);
+    TEST_EQ(true, in_mapping(found));
+    TEST_EQ(found, interner.intern(view_arr(name)));
+  }
+
+  // New strings go into the normal pools
+  const InternString* added = interner.intern(lit_view_arr("not in the snapshot"));
+  TEST_EQ(false, in_mapping(added));
+  TEST_EQ(added, interner.find(lit_view_arr("not in the snapshot")));
+  TEST_EQ(static_cast<const InternString*>(nullptr), interner.find(lit_view_arr("name500")));
+
+  // Corrupted slots, every one of them would break lookups if it was loaded
+  {
+    constexpr auto bad_path = lit_view_arr("./interner_snapshot_bad.bin");
+    OwnedArr<u8> bytes = FILES::read_full_file(snapshot_path);
+
+    u64 table_size;
+    u64 slots_offset;
+    memcpy_ts(&table_size, 1, reinterpret_cast<const u64*>(bytes.data + 16), 1);
+    memcpy_ts(&slots_offset, 1, reinterpret_cast<const u64*>(bytes.data + 32), 1);
+    u32* slots = reinterpret_cast<u32*>(bytes.data + slots_offset);
+
+    usize used = 0;
+    while (slots[used] == 0) used += 1;
+    usize empty = used;
+    while (slots[empty] != 0) empty = (empty + 1) & (table_size - 1);
+
+    const auto load_patched = [&](usize slot, u32 value) {
+      const u32 old = slots[slot];
+      slots[slot] = value;
+      {
+        FILES::OpenedFile file = FILES::replace(bad_path, FILES::OPEN_MODE::WRITE);
+        FILES::write(file.file, bytes.data, bytes.size);
+      }
+      slots[slot] = old;
+
+      StringInterner patched = {};
+      return patched.load_snapshot(bad_path);
+    };
+
+    // A tombstone
+    TEST_EQ(FILES::ErrorCode::INVALID_FILE_FORMAT, load_patched(empty, static_cast<u32>(-1)));
+    // Two slots for one record
+    TEST_EQ(FILES::ErrorCode::INVALID_FILE_FORMAT, load_patched(empty, slots[used]));
+    // A record that is not reachable from its hash, probing passes the now empty slot first
+    slots[empty] = slots[used];
+    TEST_EQ(FILES::ErrorCode::INVALID_FILE_FORMAT, load_patched(used, 0));
+    slots[empty] = 0;
+    // Unpatched it still loads
+    TEST_EQ(FILES::ErrorCode::OK, load_patched(used, slots[used]));
+  }
+
+  {
+    FILES::OpenedFile file = FILES::replace(snapshot_path, FILES::OPEN_MODE::WRITE);
+    TEST_EQ(FILES::ErrorCode::OK, file.error_code);
+    FILES::write_str(file.file, "definitely not a snapshot file");
+  }
+
+  StringInterner bad = {};
+  TEST_EQ(FILES::ErrorCode::INVALID_FILE_FORMAT, bad.load_snapshot(snapshot_path));
+  TEST_EQ(false, bad.snapshot.is_mapped());
+  TEST_EQ(static_cast<usize>(0), bad.table.num_full);
+}
+
+TEST_FUNCTION(Interned_Strings, compact_ids) {
+  CompactStringInterner interner = {};
+
+  TEST_EQ(Intern::INVALID_ID, interner.find(lit_view_arr("hello")));
+
+  const InternId hello = interner.intern(lit_view_arr("hello"));
+  const InternId world = interner.intern(lit_view_arr("world"));
+  const InternId empty = interner.intern(ViewArr<const char>{});
+
+  TEST_NEQ(hello, world);
+  TEST_NEQ(hello, empty);
+  TEST_EQ(hello, interner.intern(lit_view_arr("hello")));
+  TEST_EQ(world, interner.find(lit_view_arr("world")));
+  TEST_EQ(empty, interner.find(ViewArr<const char>{}));
+
+  TEST_STR_EQ(lit_view_arr("hello"), interner.view(hello));
+  TEST_STR_EQ(lit_view_arr("world"), interner.view(world));
+  TEST_EQ(static_cast<usize>(0), interner.view(empty).size);
+  TEST_EQ(fnv1a_hash("hello", 5), interner.hash_of(hello));
+
+  // Substrings of the arena itself
+  const InternId hell = interner.intern(view_arr(interner.view(hello), 0, 4));
+  TEST_STR_EQ(lit_view_arr("hell"), interner.view(hell));
+
+  constexpr usize COUNT = 2000;
+  InternId ids[COUNT];
+  for (usize i = 0; i < COUNT; ++i) {
+    Format::ArrayFormatter name = {};
+    Format::format_to(name, "id{}", i);
+    ids[i] = interner.intern(view_arr(name));
+  }
+
+  TEST_EQ(COUNT + 4, interner.size());
+  TEST_EQ(COUNT + 4, interner.stats().used);
+
+  InternIdHashTable<usize> table = {};
+  for (usize i = 0; i < COUNT; ++i) {
+    Format::ArrayFormatter name = {};
+    Format::format_to(name, "id{}", i);
+    TEST_EQ(ids[i], interner.find(view_arr(name)));
+    TEST_STR_EQ(view_arr(name), interner.view(ids[i]));
+
+    table.insert(ids[i], usize{ i });
+  }
+
+  for (usize i = 0; i < COUNT; ++i) {
+    TEST_EQ(i, *table.get_val(ids[i]));
+  }
+  TEST_EQ(false, table.contains(hello));
+}
+
+namespace {
+  struct ConcurrentInternShared {
+    static constexpr usize NUM_TOKENS = 2000;
+    static constexpr usize NUM_THREADS = 4;
+
+    ConcurrentStringInterner* interner;
+    ViewArr<const char> tokens[NUM_TOKENS];
+    const InternString* results[NUM_THREADS][NUM_TOKENS];
+  };
+
+  struct ConcurrentInternThread {
+    ConcurrentInternShared* shared;
+    usize index;
+  };
+
+  void concurrent_intern_thread(const ThreadHandle*, ConcurrentInternThread* data) {
+    ConcurrentInternShared* shared = data->shared;
+
+    // Each thread starts at a different point so they race on different strings
+    const usize start = data->index * (ConcurrentInternShared::NUM_TOKENS / ConcurrentInternShared::NUM_THREADS);
+    for (usize i = 0; i < ConcurrentInternShared::NUM_TOKENS; ++i) {
+      const usize t = (start + i) % ConcurrentInternShared::NUM_TOKENS;
+      shared->results[data->index][t] = shared->interner->intern(shared->tokens[t]);
+    }
+  }
+}
+
+TEST_FUNCTION(Interned_Strings, concurrent) {
+  StringInterner token_holder = {};
+  ConcurrentStringInterner interner = {};
+
+  ConcurrentInternShared shared = {};
+  shared.interner = &interner;
+  for (usize i = 0; i < ConcurrentInternShared::NUM_TOKENS; ++i) {
+    shared.tokens[i] = view_arr(token_holder.format_intern("token{}", i));
+  }
+
+  TEST_EQ(static_cast<const InternString*>(nullptr), interner.find(shared.tokens[0]));
+
+  ConcurrentInternThread data[ConcurrentInternShared::NUM_THREADS];
+  const ThreadHandle* handles[ConcurrentInternShared::NUM_THREADS];
+  for (usize i = 0; i < ConcurrentInternShared::NUM_THREADS; ++i) {
+    data[i] = { &shared, i };
+    handles[i] = start_thread<concurrent_intern_thread>(data + i);
+  }
+
+  for (usize i = 0; i < ConcurrentInternShared::NUM_THREADS; ++i) {
+    wait_for_thread_end(handles[i]);
+  }
+
+  for (usize t = 0; t < ConcurrentInternShared::NUM_TOKENS; ++t) {
+    const InternString* str = interner.find(shared.tokens[t]);
+    TEST_NEQ(static_cast<const InternString*>(nullptr), str);
+    TEST_STR_EQ(shared.tokens[t], str);
+    TEST_NEQ(shared.tokens[t].data, str->string);
+
+    for (usize i = 0; i < ConcurrentInternShared::NUM_THREADS; ++i) {
+      TEST_EQ(str, shared.results[i][t]);
+    }
+  }
+
+  TEST_EQ(ConcurrentInternShared::NUM_TOKENS, interner.stats().used);
+  TEST_EQ(static_cast<const InternString*>(&interner.empty_string), interner.intern(nullptr, 0));
+  TEST_EQ(static_cast<const InternString*>(nullptr), interner.find(lit_view_arr("missing")));
+}
+
 TEST_FUNCTION(Interned_Strings, big_creation) {
   constexpr usize SIZE = StringInterner::ALLOC_BLOCK_SIZE * 2;
   OwnedArr<char> str = new_arr<char>(SIZE);
@@ -0,0 +1,166 @@
+#include <AxleUtil/utf8.h>
+#include <AxleUtil/simd.h>
+
+#include <AxleTest/unit_tests.h>
+using namespace Axle;
+
+namespace {
+  template<typename L>
+  void for_each_level(L&& test) {
+    const SIMD::Level max = SIMD::detected_level();
+    for (u8 l = 0; l <= static_cast<u8>(max); ++l) {
+      SIMD::set_level(static_cast<SIMD::Level>(l));
+      test();
+    }
+    SIMD::set_level(max);
+  }
+
+  struct Lcg {
+    u64 state = 0x853c49e6748fea9b;
+
+    u32 next() {
+      state = state * 6364136223846793005ull + 1442695040888963407ull;
+      return static_cast<u32>(state >> 33);
+    }
+  };
+}
+
+static_assert(utf8_validate(lit_view_arr("plain")));
+static_assert(utf8_validate(lit_view_arr("\xC3\xA9t\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80")));
+static_assert(!utf8_validate(lit_view_arr("\xC0\xAF")));
+static_assert(utf8_decode("\xE2\x82\xAC", 3).code_point == 0x20AC);
+
+TEST_FUNCTION(UTF8, validate) {
+  const ViewArr<const char> invalid[] = {
+    lit_view_arr("\x80"),// lone continuation
+    lit_view_arr("\xC3"),// truncated
+    lit_view_arr("\xC0\xAF"),// overlong 2
+    lit_view_arr("\xE0\x80\xAF"),// overlong 3
+    lit_view_arr("\xF0\x80\x80\xAF"),// overlong 4
+    lit_view_arr("\xED\xA0\x80"),// surrogate
+    lit_view_arr("\xF4\x90\x80\x80"),// above U+10FFFF
+    lit_view_arr("\xF8\x88\x80\x80\x80"),// 5 bytes
+    lit_view_arr("\xE2\x82"),// truncated 3
+    lit_view_arr("\xC3\xA9\xA9"),// too many continuations
+    lit_view_arr("\xFF"),
+  };
+
+  const ViewArr<const char> valid[] = {
+    lit_view_arr("\x7F"),
+    lit_view_arr("\xC2\x80"),
+    lit_view_arr("\xDF\xBF"),
+    lit_view_arr("\xE0\xA0\x80"),
+    lit_view_arr("\xED\x9F\xBF"),
+    lit_view_arr("\xEE\x80\x80"),
+    lit_view_arr("\xF0\x90\x80\x80"),
+    lit_view_arr("\xF4\x8F\xBF\xBF"),
+  };
+
+  for_each_level([&]() {
+    char buffer[128];
+
+    // Every sequence at every position, with ascii around it so blocks get split in different places
+    for (usize at = 0; at < 70; ++at) {
+      for (const ViewArr<const char>& seq : invalid) {
+        for (usize i = 0; i < 128; ++i) buffer[i] = 'a';
+        memcpy_ts(buffer + at, 128 - at, seq.data, seq.size);
+
+        const ViewArr<const char> str = { buffer, at + seq.size + (at % 3) };
+        TEST_EQ(false, utf8_validate_scalar(str));
+        TEST_EQ(false, utf8_validate(str));
+      }
+
+      for (const ViewArr<const char>& seq : valid) {
+        for (usize i = 0; i < 128; ++i) buffer[i] = 'a';
+        memcpy_ts(buffer + at, 128 - at, seq.data, seq.size);
+
+        const ViewArr<const char> str = { buffer, at + seq.size + (at % 3) };
+        TEST_EQ(true, utf8_validate_scalar(str));
+        TEST_EQ(true, utf8_validate(str));
+      }
+    }
+
+    TEST_EQ(true, utf8_validate({}));
+  });
+}
+
+TEST_FUNCTION(UTF8, validate_matches_scalar) {
+  // Mostly valid text with random bytes flipped, the vector paths must agree with the scalar one
+  const auto sample = lit_view_arr("ascii \xC3\xA9\xC3\xA8 \xE2\x82\xAC\xE2\x84\xA2 \xF0\x9F\x98\x80\xF0\x9F\x8E\x89 text");
+
+  Lcg rng = {};
+  char buffer[256];
+
+  for_each_level([&]() {
+    for (usize round = 0; round < 2000; ++round) {
+      const usize len = rng.next() % 256;
+      for (usize i = 0; i < len; ++i) {
+        buffer[i] = sample[(i + round) % sample.size];
+      }
+
+      if (len > 0 && (round % 4) != 0) {
+        buffer[rng.next() % len] = static_cast<char>(rng.next());
+      }
+
+      const ViewArr<const char> str = { buffer, len };
+      TEST_EQ(utf8_validate_scalar(str), utf8_validate(str));
+    }
+  });
+}
+
+TEST_FUNCTION(UTF8, code_points) {
+  const auto str = lit_view_arr("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\xFFz");
+  const u32 expected[] = { 'a', 0xE9, 0x20AC, 0x1F600, UNICODE_REPLACEMENT_CHARACTER, 'z' };
+
+  CodePointIter iter = { str };
+  u32 cp;
+  usize count = 0;
+  while (iter.next(cp)) {
+    TEST_EQ(true, count < array_size(expected));
+    TEST_EQ(expected[count], cp);
+    count += 1;
+  }
+  TEST_EQ(array_size(expected), count);
+  TEST_EQ(true, iter.had_error);
+
+  for (u32 c : expected) {
+    char buffer[4];
+    const u32 n = utf8_encode(c, buffer);
+    const UTF8Decode d = utf8_decode(buffer, n);
+    TEST_EQ(n, d.length);
+    TEST_EQ(c, d.code_point);
+  }
+
+  char buffer[4];
+  TEST_EQ(static_cast<u32>(0), utf8_encode(0xD800, buffer));
+  TEST_EQ(static_cast<u32>(0), utf8_encode(0x110000, buffer));
+}
+
+TEST_FUNCTION(UTF8, transcode) {
+  for_each_level([&]() {
+    const auto str = lit_view_arr("a long run of plain ascii text \xC3\xA9 then \xF0\x9F\x98\x80 and more ascii after");
+
+    Array<char16_t> wide = {};
+    TEST_EQ(true, utf8_to_utf16(str, wide));
+
+    // One unit per ascii byte, 1 for the e acute and 2 for the emoji
+    TEST_EQ(str.size - 1 - 2, wide.size);
+    TEST_EQ(static_cast<u32>(0xE9), static_cast<u32>(wide[31]));
+    TEST_EQ(static_cast<u32>(0xD83D), static_cast<u32>(wide[38]));
+    TEST_EQ(static_cast<u32>(0xDE00), static_cast<u32>(wide[39]));
+
+    Array<char> narrow = {};
+    TEST_EQ(true, utf16_to_utf8(view_arr(wide), narrow));
+    TEST_STR_EQ(str, view_arr(narrow));
+
+    Array<char16_t> bad = {};
+    TEST_EQ(false, utf8_to_utf16(lit_view_arr("x\xFFy"), bad));
+    TEST_EQ(static_cast<usize>(3), bad.size);
+    TEST_EQ(UNICODE_REPLACEMENT_CHARACTER, static_cast<u32>(bad[1]));
+
+    const char16_t lone[] = { u'a', 0xD800, u'b' };
+    Array<char> lone_out = {};
+    TEST_EQ(false, utf16_to_utf8({ lone, 3 }, lone_out));
+    TEST_STR_EQ(lit_view_arr("a\xEF\xBF\xBD" "b"), view_arr(lone_out));
+  });
+}